@@ -0,0 +1,136 @@
+#ifndef DG_ADT_ARENA_H_
+#define DG_ADT_ARENA_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dg {
+namespace ADT {
+
+///
+// Bump-pointer allocator. Objects are placed one after another
+// in large chunks, the memory is released all at once when
+// the arena is destroyed. The arena never calls destructors
+// of the objects, that is up to the user (see ArenaDeleter).
+class Arena {
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> _chunks;
+    char *_cur{nullptr};
+    char *_end{nullptr};
+    size_t _chunkSize;
+
+    void newChunk(size_t size) {
+        _chunks.emplace_back(new char[size]);
+        _cur = _chunks.back().get();
+        _end = _cur + size;
+    }
+
+  public:
+    Arena(size_t chunkSize = DEFAULT_CHUNK_SIZE) : _chunkSize(chunkSize) {}
+
+    Arena(Arena &&oth) noexcept
+            : _chunks(std::move(oth._chunks)), _cur(oth._cur), _end(oth._end),
+              _chunkSize(oth._chunkSize) {
+        oth._chunks.clear();
+        oth._cur = oth._end = nullptr;
+    }
+
+    // swap the memory, so that objects that were allocated in this
+    // arena stay valid until 'oth' is destroyed (the owners of the
+    // objects may be destroyed only after this assignment)
+    Arena &operator=(Arena &&oth) noexcept {
+        _chunks.swap(oth._chunks);
+        std::swap(_cur, oth._cur);
+        std::swap(_end, oth._end);
+        std::swap(_chunkSize, oth._chunkSize);
+        return *this;
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        assert(align > 0 && (align & (align - 1)) == 0 &&
+               "Alignment must be a power of two");
+        auto addr = reinterpret_cast<uintptr_t>(_cur);
+        auto aligned = (addr + align - 1) & ~(uintptr_t(align) - 1);
+        if (_cur == nullptr ||
+            aligned + size > reinterpret_cast<uintptr_t>(_end)) {
+            // objects bigger than the default chunk get their own chunk
+            newChunk(std::max(_chunkSize, size + align));
+            addr = reinterpret_cast<uintptr_t>(_cur);
+            aligned = (addr + align - 1) & ~(uintptr_t(align) - 1);
+        }
+
+        _cur = reinterpret_cast<char *>(aligned + size);
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    template <typename T, typename... Args>
+    T *create(Args &&...args) {
+        void *mem = allocate(sizeof(T), alignof(T));
+        return new (mem) T(std::forward<Args>(args)...);
+    }
+
+    size_t chunksNum() const { return _chunks.size(); }
+};
+
+///
+// Deleter for std::unique_ptr that owns an object allocated
+// in an Arena -- it only runs the destructor
+template <typename T>
+struct ArenaDeleter {
+    void operator()(T *obj) const { obj->~T(); }
+};
+
+///
+// Array of objects indexed by a dense number (e.g., an id of a node).
+// The objects are stored one after another in chunks, so that walking
+// the array walks the memory sequentially, and unlike in std::vector,
+// the objects never move -- pointers to them stay valid while
+// the array grows.
+template <typename T, size_t ChunkSize = 1024>
+class ChunkedArray {
+    std::vector<std::vector<T>> _chunks;
+    size_t _size{0};
+
+  public:
+    template <typename... Args>
+    T &emplace_back(Args &&...args) {
+        if (_size % ChunkSize == 0) {
+            _chunks.emplace_back();
+            _chunks.back().reserve(ChunkSize);
+        }
+
+        auto &chunk = _chunks.back();
+        assert(chunk.size() < ChunkSize && "The chunk would reallocate");
+        chunk.emplace_back(std::forward<Args>(args)...);
+        ++_size;
+        return chunk.back();
+    }
+
+    T &operator[](size_t idx) {
+        assert(idx < _size);
+        return _chunks[idx / ChunkSize][idx % ChunkSize];
+    }
+
+    const T &operator[](size_t idx) const {
+        assert(idx < _size);
+        return _chunks[idx / ChunkSize][idx % ChunkSize];
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_ADT_ARENA_H_
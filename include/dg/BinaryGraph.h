@@ -0,0 +1,215 @@
+#ifndef DG_BINARY_GRAPH_H_
+#define DG_BINARY_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dg {
+namespace binary {
+
+// Compact binary format of dependence graphs. The graph is identified
+// by numbers only, so it can be loaded and traversed without
+// the bitcode (and without building LLVM objects). The layout of the file
+// (all numbers are in the native byte order and all sections are aligned
+// to 8 bytes, so that they can be used right from the mapped memory):
+//
+//   header:     Header
+//   names:      offsets of the names (uint32_t [numNames + 1])
+//               and the NUL-terminated names of functions and globals
+//   functions:  FunctionRecord [numFunctions]
+//   nodes:      NodeRecord [numNodes], global nodes go first and then
+//               the nodes of every function form a contiguous range
+//   edges:      for every kind of edges and both directions the edges
+//               in the CSR format: the indices of the first target
+//               for every node (uint32_t [numNodes + 1]) and the targets
+//               (uint32_t [numEdges]). The targets are sorted.
+//
+// A node refers to its LLVM value in the same way as the stored results
+// of pointer analysis: by the name of the global or function and the index
+// of the argument or instruction in the function.
+
+const uint32_t NONE = ~static_cast<uint32_t>(0);
+const uint32_t VERSION = 1;
+
+enum class EdgeKind : uint32_t {
+    CONTROL = 0,      // the source controls the target
+    DATA = 1,         // the target reads memory written by the source
+    USE = 2,          // the target uses the value of the source
+    INTERFERENCE = 3, // data dependence between threads
+    CALL = 4,         // from a call site to the entry of the called function
+    PARAMETER = 5,    // between actual and formal parameters
+    NUM_KINDS = 6
+};
+
+enum class ValueKind : uint8_t {
+    NONE = 0, // the node has no value (or the value has no identifier)
+    GLOBAL = 1,
+    FUNCTION = 2,
+    ARGUMENT = 3,
+    INSTRUCTION = 4
+};
+
+enum class NodeKind : uint8_t {
+    VALUE = 0, // an instruction, an argument, a global, ...
+    PARAMETER_IN = 1,
+    PARAMETER_OUT = 2,
+    NORETURN = 3,
+    RETURN = 4,
+    ARTIFICIAL = 5 // e.g., the unified exit node
+};
+
+struct NodeRecord {
+    NodeKind kind{NodeKind::VALUE};
+    ValueKind valueKind{ValueKind::NONE};
+    uint16_t reserved{0};
+    // index of the function or NONE for global nodes
+    uint32_t function{NONE};
+    // name of the global or function (the function of arguments
+    // and instructions) and the index of the argument or instruction
+    uint32_t name{NONE};
+    uint32_t index{0};
+    // the call site of actual parameters, NONE for other nodes
+    uint32_t owner{NONE};
+};
+
+struct FunctionRecord {
+    uint32_t name; // NONE for unnamed functions
+    uint32_t firstNode;
+    uint32_t numNodes;
+    uint32_t entry; // the entry node or NONE
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t numNames;
+    uint32_t numFunctions;
+    uint32_t numNodes;
+    uint64_t names;
+    uint64_t functions;
+    uint64_t nodes;
+    // offsets of the successors and predecessors
+    uint64_t edges[static_cast<unsigned>(EdgeKind::NUM_KINDS)][2];
+};
+
+///
+// Collects the graph and writes it into a file.
+// The nodes of a function must be added right after the function.
+class BinaryGraphWriter {
+    std::vector<std::string> _names;
+    std::vector<FunctionRecord> _functions;
+    std::vector<NodeRecord> _nodes;
+    std::vector<std::pair<uint32_t, uint32_t>>
+            _edges[static_cast<unsigned>(EdgeKind::NUM_KINDS)];
+
+  public:
+    // names referred by nodes and functions
+    void setNames(std::vector<std::string> names) { _names = std::move(names); }
+
+    // start a new function, the next nodes belong to this function
+    uint32_t addFunction(uint32_t name);
+    void setEntry(uint32_t function, uint32_t node) {
+        _functions[function].entry = node;
+    }
+
+    // add a node to the last added function
+    // (or a global node if there is no function yet)
+    uint32_t addNode(NodeRecord node);
+
+    void addEdge(EdgeKind kind, uint32_t src, uint32_t dst) {
+        _edges[static_cast<unsigned>(kind)].emplace_back(src, dst);
+    }
+
+    size_t getNumNodes() const { return _nodes.size(); }
+
+    bool write(const std::string &path) const;
+};
+
+///
+// Graph stored by BinaryGraphWriter. The file is mapped
+// into memory and the records are used in place.
+class BinaryGraph {
+    void *_data{nullptr};
+    size_t _size{0};
+
+    const Header *_header{nullptr};
+    const uint32_t *_nameOffsets{nullptr};
+    const char *_names{nullptr};
+    const FunctionRecord *_functions{nullptr};
+    const NodeRecord *_nodes{nullptr};
+    const uint32_t *_edges[static_cast<unsigned>(EdgeKind::NUM_KINDS)][2];
+
+    bool check();
+
+  public:
+    class edges_range {
+        const uint32_t *_begin;
+        const uint32_t *_end;
+
+      public:
+        edges_range(const uint32_t *b, const uint32_t *e)
+                : _begin(b), _end(e) {}
+
+        const uint32_t *begin() const { return _begin; }
+        const uint32_t *end() const { return _end; }
+        size_t size() const { return _end - _begin; }
+        bool empty() const { return _begin == _end; }
+    };
+
+    BinaryGraph() = default;
+    BinaryGraph(const BinaryGraph &) = delete;
+    BinaryGraph &operator=(const BinaryGraph &) = delete;
+    ~BinaryGraph() { close(); }
+
+    // map the file into the memory, return false if the file
+    // cannot be read or is not a valid graph
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return _header != nullptr; }
+
+    uint32_t getNumNames() const { return _header->numNames; }
+    uint32_t getNumFunctions() const { return _header->numFunctions; }
+    uint32_t getNumNodes() const { return _header->numNodes; }
+
+    const char *getName(uint32_t idx) const {
+        return _names + _nameOffsets[idx];
+    }
+
+    const FunctionRecord &getFunction(uint32_t idx) const {
+        return _functions[idx];
+    }
+
+    // the index of the function with the given name or NONE
+    uint32_t findFunction(const std::string &name) const;
+
+    const NodeRecord &getNode(uint32_t idx) const { return _nodes[idx]; }
+
+    // nodes that are the targets of the edges from the node
+    edges_range getSuccessors(EdgeKind kind, uint32_t node) const {
+        return getEdges(kind, node, 0);
+    }
+
+    // nodes that are the sources of the edges to the node
+    edges_range getPredecessors(EdgeKind kind, uint32_t node) const {
+        return getEdges(kind, node, 1);
+    }
+
+    size_t getNumEdges(EdgeKind kind) const {
+        return _edges[static_cast<unsigned>(kind)][0][getNumNodes()];
+    }
+
+  private:
+    edges_range getEdges(EdgeKind kind, uint32_t node, unsigned dir) const {
+        const auto *index = _edges[static_cast<unsigned>(kind)][dir];
+        const auto *targets = index + getNumNodes() + 1;
+        return {targets + index[node], targets + index[node + 1]};
+    }
+};
+
+} // namespace binary
+} // namespace dg
+
+#endif // DG_BINARY_GRAPH_H_
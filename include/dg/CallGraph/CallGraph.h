@@ -1,10 +1,14 @@
 #ifndef DG_GENERIC_CALLGRAPH_H_
 #define DG_GENERIC_CALLGRAPH_H_
 
-#include <map>
+#include <cassert>
+#include <deque>
+#include <tuple>
+#include <utility>
 #include <vector>
 
-#include "dg/util/iterators.h"
+#include "dg/ADT/Bitvector.h"
+#include "dg/ADT/HashMap.h"
 
 namespace dg {
 
@@ -16,11 +20,8 @@ class GenericCallGraph {
         unsigned _scc_id{0};
         std::vector<FuncNode *> _calls;
         std::vector<FuncNode *> _callers;
-
-        template <typename Cont>
-        bool _contains(const FuncNode *x, const Cont &C) const {
-            return dg::any_of(C, [x](FuncNode *s) { return s == x; });
-        }
+        // the ids of the called functions (to find duplicate calls)
+        ADT::SparseBitvectorHashImpl _calls_ids;
 
       public:
         const ValueT value;
@@ -28,19 +29,20 @@ class GenericCallGraph {
         FuncNode(unsigned id, const ValueT &nd) : _id(id), value(nd){};
         FuncNode(FuncNode &&) = default;
 
-        bool calls(const FuncNode *x) const { return _contains(x, _calls); }
-        bool isCalledBy(FuncNode *x) const { return _contains(x, _callers); }
+        bool calls(const FuncNode *x) const { return _calls_ids.get(x->_id); }
+        bool isCalledBy(const FuncNode *x) const { return x->calls(this); }
 
         unsigned getID() const { return _id; }
         unsigned getSCCId() const { return _scc_id; }
         void setSCCId(unsigned id) { _scc_id = id; }
 
         bool addCall(FuncNode *x) {
-            if (calls(x))
+            if (_calls_ids.set(x->_id))
                 return false;
+            // we add the callers only here, so 'x' cannot
+            // have 'this' among callers yet
             _calls.push_back(x);
-            if (!x->isCalledBy(this))
-                x->_callers.push_back(this);
+            x->_callers.push_back(this);
             return true;
         }
 
@@ -53,18 +55,28 @@ class GenericCallGraph {
     };
 
   private:
-    unsigned last_id{0};
+    // the nodes with their values, the node with id 'i' is at 'i - 1'
+    // (deque, so that the nodes do not move)
+    std::deque<std::pair<const ValueT, FuncNode>> _nodes;
+    dg::HashMap<ValueT, FuncNode *> _mapping;
 
     FuncNode *getOrCreate(const ValueT &v) {
         auto it = _mapping.find(v);
-        if (it == _mapping.end()) {
-            auto newIt = _mapping.emplace(v, FuncNode(++last_id, v));
-            return &newIt.first->second;
-        }
-        return &it->second;
+        if (it != _mapping.end())
+            return it->second;
+
+        unsigned id = _nodes.size() + 1;
+        _nodes.emplace_back(std::piecewise_construct, std::forward_as_tuple(v),
+                            std::forward_as_tuple(id, v));
+        auto *nd = &_nodes.back().second;
+        _mapping.put(v, nd);
+        return nd;
     }
 
-    std::map<const ValueT, FuncNode> _mapping;
+    static const std::vector<FuncNode *> &_empty() {
+        static const std::vector<FuncNode *> empty;
+        return empty;
+    }
 
   public:
     // just create a node for the value
@@ -83,7 +95,7 @@ class GenericCallGraph {
         if (it == _mapping.end()) {
             return nullptr;
         }
-        return &it->second;
+        return it->second;
     }
 
     FuncNode *get(const ValueT &v) {
@@ -91,17 +103,40 @@ class GenericCallGraph {
         if (it == _mapping.end()) {
             return nullptr;
         }
-        return &it->second;
+        return it->second;
+    }
+
+    // get the node by its id, the ids are 1, ..., size()
+    const FuncNode *getNode(unsigned id) const {
+        assert(id > 0 && id <= _nodes.size());
+        return &_nodes[id - 1].second;
+    }
+
+    FuncNode *getNode(unsigned id) {
+        assert(id > 0 && id <= _nodes.size());
+        return &_nodes[id - 1].second;
     }
 
-    bool empty() const { return _mapping.empty(); }
+    // the functions called from 'v' and the functions that call 'v'
+    // (no copying, empty if 'v' is not in the graph)
+    const std::vector<FuncNode *> &callees(const ValueT &v) const {
+        const auto *nd = get(v);
+        return nd ? nd->getCalls() : _empty();
+    }
 
-    auto begin() -> decltype(_mapping.begin()) { return _mapping.begin(); }
-    auto end() -> decltype(_mapping.end()) { return _mapping.end(); }
-    auto begin() const -> decltype(_mapping.begin()) {
-        return _mapping.begin();
+    const std::vector<FuncNode *> &callers(const ValueT &v) const {
+        const auto *nd = get(v);
+        return nd ? nd->getCallers() : _empty();
     }
-    auto end() const -> decltype(_mapping.end()) { return _mapping.end(); }
+
+    bool empty() const { return _nodes.empty(); }
+    size_t size() const { return _nodes.size(); }
+
+    // iterate over the pairs (value, node) in the order of ids
+    auto begin() -> decltype(_nodes.begin()) { return _nodes.begin(); }
+    auto end() -> decltype(_nodes.end()) { return _nodes.end(); }
+    auto begin() const -> decltype(_nodes.begin()) { return _nodes.begin(); }
+    auto end() const -> decltype(_nodes.end()) { return _nodes.end(); }
 };
 
 } // namespace dg
@@ -0,0 +1,251 @@
+#ifndef DG_CALLGRAPH_SCC_H_
+#define DG_CALLGRAPH_SCC_H_
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dg/CallGraph/CallGraph.h"
+#include "dg/util/parallel.h"
+
+namespace dg {
+
+///
+/// Condensation of a call graph into strongly connected components.
+/// The components are numbered bottom-up, i.e., the components called
+/// from a component have lower numbers than the component itself.
+/// The number of the component of a function is set to its node
+/// (FuncNode::getSCCId()).
+///
+template <typename ValueT>
+class CallGraphSCC {
+  public:
+    using CallGraphT = GenericCallGraph<ValueT>;
+    using FuncNode = typename CallGraphT::FuncNode;
+
+    class Component {
+        friend class CallGraphSCC<ValueT>;
+
+        unsigned _id;
+        unsigned _level{0};
+        bool _recursive{false};
+        std::vector<FuncNode *> _nodes;
+        // the components called from this component and the components
+        // that call this component
+        std::vector<unsigned> _callees;
+        std::vector<unsigned> _callers;
+
+      public:
+        Component(unsigned id) : _id(id) {}
+
+        unsigned getID() const { return _id; }
+        // the length of the longest chain of calls to other components,
+        // i.e., 0 for components that call no other component
+        unsigned getLevel() const { return _level; }
+        // are there (mutually) recursive functions in the component?
+        bool isRecursive() const { return _recursive; }
+
+        const std::vector<FuncNode *> &getNodes() const { return _nodes; }
+        const std::vector<unsigned> &getCallees() const { return _callees; }
+        const std::vector<unsigned> &getCallers() const { return _callers; }
+    };
+
+  private:
+    std::vector<Component> _components;
+    unsigned _levels{0};
+
+    // Tarjan's algorithm, without recursion as the chains
+    // of calls can be very long
+    void _computeComponents(CallGraphT &cg) {
+        struct NodeInfo {
+            unsigned dfs_id{0};
+            unsigned lowpt{0};
+            bool on_stack{false};
+        };
+
+        std::unordered_map<const FuncNode *, NodeInfo> info;
+        std::vector<FuncNode *> stack;
+        // the DFS stack, the node and the index of its next callee
+        std::vector<std::pair<FuncNode *, size_t>> dfs;
+        unsigned index = 0;
+
+        auto discover = [&](FuncNode *nd) {
+            auto &ni = info[nd];
+            ni.dfs_id = ni.lowpt = ++index;
+            ni.on_stack = true;
+            stack.push_back(nd);
+            dfs.emplace_back(nd, 0);
+        };
+
+        for (auto &it : cg) {
+            if (info[&it.second].dfs_id != 0)
+                continue;
+
+            discover(&it.second);
+            while (!dfs.empty()) {
+                auto *nd = dfs.back().first;
+                const auto &calls = nd->getCalls();
+                if (dfs.back().second < calls.size()) {
+                    auto *callee = calls[dfs.back().second++];
+                    const auto &ci = info[callee];
+                    if (ci.dfs_id == 0) {
+                        discover(callee);
+                    } else if (ci.on_stack) {
+                        auto &ni = info[nd];
+                        ni.lowpt = std::min(ni.lowpt, ci.dfs_id);
+                    }
+                    continue;
+                }
+
+                dfs.pop_back();
+                const auto &ni = info[nd];
+                if (!dfs.empty()) {
+                    auto &pi = info[dfs.back().first];
+                    pi.lowpt = std::min(pi.lowpt, ni.lowpt);
+                }
+                if (ni.lowpt != ni.dfs_id)
+                    continue;
+
+                unsigned id = _components.size();
+                _components.emplace_back(id);
+                auto &comp = _components.back();
+                FuncNode *w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    info[w].on_stack = false;
+                    w->setSCCId(id);
+                    comp._nodes.push_back(w);
+                } while (w != nd);
+                comp._recursive = comp._nodes.size() > 1 || nd->calls(nd);
+            }
+        }
+        assert(stack.empty());
+    }
+
+    void _computeEdges() {
+        for (auto &comp : _components) {
+            for (auto *nd : comp._nodes) {
+                for (auto *callee : nd->getCalls()) {
+                    if (callee->getSCCId() != comp._id)
+                        comp._callees.push_back(callee->getSCCId());
+                }
+            }
+            std::sort(comp._callees.begin(), comp._callees.end());
+            comp._callees.erase(
+                    std::unique(comp._callees.begin(), comp._callees.end()),
+                    comp._callees.end());
+
+            // the callees have lower numbers, so they are done already
+            for (auto callee : comp._callees) {
+                auto &C = _components[callee];
+                assert(callee < comp._id && "Components are not bottom-up");
+                C._callers.push_back(comp._id);
+                comp._level = std::max(comp._level, C._level + 1);
+            }
+            _levels = std::max(_levels, comp._level + 1);
+        }
+    }
+
+    template <typename Fun>
+    void _run(Fun &fun, unsigned workers, bool bottomUp) {
+        const size_t N = _components.size();
+        workers = getWorkersNum(workers, N);
+        if (workers == 1) {
+            for (size_t i = 0; i < N; ++i)
+                fun(_components[bottomUp ? i : N - i - 1]);
+            return;
+        }
+
+        // the number of components that must be done before
+        // the component and the components that can run now
+        std::vector<size_t> pending(N);
+        std::vector<unsigned> ready;
+        for (const auto &comp : _components) {
+            const auto &deps = bottomUp ? comp._callees : comp._callers;
+            pending[comp._id] = deps.size();
+            if (deps.empty())
+                ready.push_back(comp._id);
+        }
+
+        std::mutex lock;
+        std::condition_variable cond;
+        size_t done = 0;
+        auto worker = [&](unsigned /* id */) {
+            std::unique_lock<std::mutex> guard(lock);
+            while (true) {
+                cond.wait(guard, [&] { return !ready.empty() || done == N; });
+                if (ready.empty())
+                    return;
+
+                auto &comp = _components[ready.back()];
+                ready.pop_back();
+                guard.unlock();
+                fun(comp);
+                guard.lock();
+
+                ++done;
+                for (auto dep : bottomUp ? comp._callers : comp._callees) {
+                    if (--pending[dep] == 0)
+                        ready.push_back(dep);
+                }
+                cond.notify_all();
+            }
+        };
+
+        runWorkers(workers, worker);
+        assert(done == N);
+    }
+
+  public:
+    CallGraphSCC(CallGraphT &cg) {
+        _computeComponents(cg);
+        _computeEdges();
+    }
+
+    size_t size() const { return _components.size(); }
+    // the number of different levels of components
+    unsigned getNumLevels() const { return _levels; }
+
+    const Component &operator[](unsigned idx) const {
+        assert(idx < _components.size());
+        return _components[idx];
+    }
+
+    const Component &getComponent(const FuncNode *nd) const {
+        return (*this)[nd->getSCCId()];
+    }
+
+    auto begin() const -> decltype(_components.begin()) {
+        return _components.begin();
+    }
+    auto end() const -> decltype(_components.end()) {
+        return _components.end();
+    }
+
+    ///
+    /// Call 'fun' on every component once the components that it calls
+    /// are done. Independent components can be processed in parallel
+    /// by 'workers' threads (0 means one per hardware thread), 'fun'
+    /// must be thread-safe then. With one worker (the default),
+    /// the components are processed in the order of their numbers.
+    ///
+    template <typename Fun>
+    void runBottomUp(Fun fun, unsigned workers = 1) {
+        _run(fun, workers, /* bottomUp = */ true);
+    }
+
+    /// The same as runBottomUp(), but the callers go first.
+    template <typename Fun>
+    void runTopDown(Fun fun, unsigned workers = 1) {
+        _run(fun, workers, /* bottomUp = */ false);
+    }
+};
+
+} // namespace dg
+
+#endif
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <vector>
 
 #include "dg/DFS.h"
 #include "dg/DependenceGraph.h"
@@ -211,6 +212,10 @@ class DG2Dot {
         if (out.is_open())
             out.close();
 
+        // the dumps consist of many small writes,
+        // give the stream a big buffer (must be set before opening)
+        outBuffer.resize(1 << 20);
+        out.rdbuf()->pubsetbuf(outBuffer.data(), outBuffer.size());
         out.open(new_file);
         file = new_file;
     }
@@ -581,6 +586,7 @@ class DG2Dot {
     DependenceGraph<NodeT> *dg;
     const char *file;
     std::set<DependenceGraph<NodeT> *> subgraphs;
+    std::vector<char> outBuffer;
 
   protected:
     std::ofstream out;
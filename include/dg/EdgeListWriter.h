@@ -0,0 +1,186 @@
+#ifndef DG_EDGE_LIST_WRITER_H_
+#define DG_EDGE_LIST_WRITER_H_
+
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dg {
+namespace debug {
+
+enum class EdgeListFormat { JSON, CSV };
+
+///
+// Streaming writer of graphs in a compact format for machine consumption.
+// The nodes and edges are written right away into a buffered file,
+// nothing is kept in memory. Nodes are identified by numbers, so
+// an edge may refer to a node from another file (shard).
+//
+// JSON: {"nodes":[{"id":1,"fun":"main","label":"..."},...],
+//        "edges":[[1,2,"dd"],...]}
+// CSV:  node,1,"main","..."
+//       edge,1,2,dd
+//
+// All nodes of a file must be written before its edges.
+class EdgeListWriter {
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    EdgeListFormat _format;
+    std::vector<char> _buffer;
+    std::filebuf _file;
+    // writes either into _file or into the buffer of std::cout
+    std::ostream _out{nullptr};
+
+    enum class Section { NONE, NODES, EDGES } _section{Section::NONE};
+    bool _first{true};
+
+    void writeJSONString(const std::string &str) {
+        _out << '"';
+        for (char c : str) {
+            switch (c) {
+            case '"':
+                _out << "\\\"";
+                break;
+            case '\\':
+                _out << "\\\\";
+                break;
+            case '\n':
+                _out << "\\n";
+                break;
+            case '\t':
+                _out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char *hex = "0123456789abcdef";
+                    _out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+                } else {
+                    _out << c;
+                }
+            }
+        }
+        _out << '"';
+    }
+
+    void writeCSVString(const std::string &str) {
+        _out << '"';
+        for (char c : str) {
+            if (c == '"')
+                _out << '"';
+            _out << c;
+        }
+        _out << '"';
+    }
+
+    // start the section of nodes or edges (JSON only)
+    void section(Section s) {
+        assert(_section <= s && "Nodes must be written before edges");
+        if (_format != EdgeListFormat::JSON || _section == s)
+            return;
+
+        if (_section == Section::NONE)
+            _out << "{\"nodes\":[";
+        if (s == Section::EDGES)
+            _out << "],\n\"edges\":[";
+
+        _section = s;
+        _first = true;
+    }
+
+    void separator() {
+        if (!_first)
+            _out << ",\n";
+        _first = false;
+    }
+
+  public:
+    EdgeListWriter(EdgeListFormat format) : _format(format) {
+        _buffer.resize(BUFFER_SIZE);
+    }
+
+    ~EdgeListWriter() { close(); }
+
+    EdgeListFormat getFormat() const { return _format; }
+
+    const char *getSuffix() const {
+        return _format == EdgeListFormat::JSON ? ".json" : ".csv";
+    }
+
+    // close the current file (if any) and open a new one,
+    // nullptr means the standard output
+    bool open(const char *file = nullptr) {
+        close();
+
+        if (file) {
+            // the buffer must be set before opening the file
+            _file.pubsetbuf(_buffer.data(), _buffer.size());
+            if (!_file.open(file, std::ios::out | std::ios::trunc)) {
+                std::cerr << "Failed opening file '" << file << "'"
+                          << std::endl;
+                return false;
+            }
+            _out.rdbuf(&_file);
+        } else {
+            // do not reopen /dev/stdout, that is not portable
+            // and it would truncate a file that stdout is appended to
+            _out.rdbuf(std::cout.rdbuf());
+        }
+
+        _section = Section::NONE;
+        _first = true;
+        return true;
+    }
+
+    void close() {
+        if (!_out.rdbuf())
+            return;
+
+        if (_format == EdgeListFormat::JSON) {
+            section(Section::EDGES);
+            _out << "]}\n";
+        }
+
+        _out.flush();
+        if (_file.is_open())
+            _file.close();
+        _out.rdbuf(nullptr);
+    }
+
+    void node(unsigned id, const std::string &fun, const std::string &label) {
+        section(Section::NODES);
+
+        if (_format == EdgeListFormat::JSON) {
+            separator();
+            _out << "{\"id\":" << id << ",\"fun\":";
+            writeJSONString(fun);
+            _out << ",\"label\":";
+            writeJSONString(label);
+            _out << '}';
+        } else {
+            _out << "node," << id << ',';
+            writeCSVString(fun);
+            _out << ',';
+            writeCSVString(label);
+            _out << '\n';
+        }
+    }
+
+    void edge(unsigned src, unsigned dst, const char *kind) {
+        section(Section::EDGES);
+
+        if (_format == EdgeListFormat::JSON) {
+            separator();
+            _out << '[' << src << ',' << dst << ",\"" << kind << "\"]";
+        } else {
+            _out << "edge," << src << ',' << dst << ',' << kind << '\n';
+        }
+    }
+};
+
+} // namespace debug
+} // namespace dg
+
+#endif // DG_EDGE_LIST_WRITER_H_
@@ -119,6 +119,16 @@ inline const char *PSNodeTypeToCString(enum PSNodeType type) {
 class PointerGraph;
 class PointerSubgraph;
 
+///
+// The id of a new node and the storage for its points-to set.
+// PointerGraph keeps the points-to sets of its nodes in a dense
+// array indexed by the ids, next to each other in the order in
+// which the solver usually walks them, instead of inside the nodes.
+struct PSNodeSlot {
+    unsigned id;
+    PointsToSetT *pointsTo;
+};
+
 class PSNode : public SubgraphNode<PSNode> {
   public:
     using IDType = SubgraphNode<PSNode>::IDType;
@@ -137,8 +147,6 @@ class PSNode : public SubgraphNode<PSNode> {
     // in some cases we need to know from which function the node is
     PointerSubgraph *_parent = nullptr;
 
-    unsigned int dfsid = 0;
-
   public:
     ///
     // Construct a PSNode
@@ -188,7 +196,10 @@ class PSNode : public SubgraphNode<PSNode> {
     //               invalidates memory after returning from a function
     // FREE:         invalidates memory after calling free function on a pointer
 
-    PSNode(IDType id, PSNodeType t) : SubgraphNode<PSNode>(id), type(t) {
+    PSNode(PSNodeSlot slot, PSNodeType t)
+            : SubgraphNode<PSNode>(slot.id), type(t),
+              pointsTo(*slot.pointsTo) {
+        assert(pointsTo.empty() && "The points-to set is already used");
         switch (type) {
         case PSNodeType::ALLOC:
         case PSNodeType::FUNCTION:
@@ -203,7 +214,8 @@ class PSNode : public SubgraphNode<PSNode> {
 
     // Unfortunately, constructors cannot use enums in templates
     template <typename... Args>
-    PSNode(IDType id, PSNodeType type, Args &&...args) : PSNode(id, type) {
+    PSNode(PSNodeSlot slot, PSNodeType type, Args &&...args)
+            : PSNode(slot, type) {
         addOperand(std::forward<Args>(args)...);
     }
 
@@ -228,8 +240,9 @@ class PSNode : public SubgraphNode<PSNode> {
     bool isInvalidated() const { return type == PSNodeType::INVALIDATED; }
 
     // make this public, that's basically the only
-    // reason the PointerGraph node exists, so don't hide it
-    PointsToSetT pointsTo;
+    // reason the PointerGraph node exists, so don't hide it.
+    // The set itself lives in the dense array of PointerGraph.
+    PointsToSetT &pointsTo;
 
     // convenient helper
     bool addPointsTo(PSNode *n, Offset o) {
@@ -320,8 +333,8 @@ class PSNodeAlloc : public PSNode {
     bool is_temporary = false;
 
   public:
-    PSNodeAlloc(IDType id, bool isTemp = false)
-            : PSNode(id, PSNodeType::ALLOC), is_temporary(isTemp) {}
+    PSNodeAlloc(PSNodeSlot slot, bool isTemp = false)
+            : PSNode(slot, PSNodeType::ALLOC), is_temporary(isTemp) {}
 
     template <typename T>
     static auto get(T *n) -> decltype(PSNodeGetter<PSNodeAlloc>::get(n)) {
@@ -346,8 +359,8 @@ class PSNodeAlloc : public PSNode {
 
 #if 0
 class PSNodeTemporaryAlloc : public PSNodeAlloc {
-    PSNodeTemporaryAlloc(IDType id)
-    : PSNodeAlloc(id, PSNodeType::ALLOC, /* isTemp */ true) {}
+    PSNodeTemporaryAlloc(PSNodeSlot slot)
+    : PSNodeAlloc(slot, PSNodeType::ALLOC, /* isTemp */ true) {}
 
     static PSNodeTemporaryAlloc *get(PSNode *n) {
         if (auto alloc = PSNodeAlloc::get(n)) {
@@ -364,8 +377,8 @@ class PSNodeConstant : public PSNode {
     Offset offset;
 
   public:
-    PSNodeConstant(IDType id, PSNode *op, Offset offset)
-            : PSNode(id, PSNodeType::CONSTANT, op), offset(offset) {
+    PSNodeConstant(PSNodeSlot slot, PSNode *op, Offset offset)
+            : PSNode(slot, PSNodeType::CONSTANT, op), offset(offset) {
         addPointsTo(op, offset);
     }
 
@@ -386,8 +399,8 @@ class PSNodeMemcpy : public PSNode {
     Offset len;
 
   public:
-    PSNodeMemcpy(IDType id, PSNode *src, PSNode *dest, Offset len)
-            : PSNode(id, PSNodeType::MEMCPY, src, dest), len(len) {}
+    PSNodeMemcpy(PSNodeSlot slot, PSNode *src, PSNode *dest, Offset len)
+            : PSNode(slot, PSNodeType::MEMCPY, src, dest), len(len) {}
 
     static PSNodeMemcpy *get(PSNode *n) {
         return isa<PSNodeType::MEMCPY>(n) ? static_cast<PSNodeMemcpy *>(n)
@@ -405,8 +418,8 @@ class PSNodeGep : public PSNode {
     Offset offset;
 
   public:
-    PSNodeGep(IDType id, PSNode *src, Offset o)
-            : PSNode(id, PSNodeType::GEP, src), offset(o) {}
+    PSNodeGep(PSNodeSlot slot, PSNode *src, Offset o)
+            : PSNode(slot, PSNodeType::GEP, src), offset(o) {}
 
     static PSNodeGep *get(PSNode *n) {
         return isa<PSNodeType::GEP>(n) ? static_cast<PSNodeGep *>(n) : nullptr;
@@ -426,8 +439,8 @@ class PSNodeEntry : public PSNode {
     std::vector<PSNode *> callers;
 
   public:
-    PSNodeEntry(IDType id, std::string name = "not-known")
-            : PSNode(id, PSNodeType::ENTRY), functionName(std::move(name)) {}
+    PSNodeEntry(PSNodeSlot slot, std::string name = "not-known")
+            : PSNode(slot, PSNodeType::ENTRY), functionName(std::move(name)) {}
 
     static PSNodeEntry *get(PSNode *n) {
         return isa<PSNodeType::ENTRY>(n) ? static_cast<PSNodeEntry *>(n)
@@ -460,10 +473,10 @@ class PSNodeCall : public PSNode {
     PSNode *callReturn{nullptr};
 
   public:
-    PSNodeCall(IDType id) : PSNode(id, PSNodeType::CALL) {}
+    PSNodeCall(PSNodeSlot slot) : PSNode(slot, PSNodeType::CALL) {}
 
-    PSNodeCall(IDType id, PSNode *op)
-            : PSNode(id, PSNodeType::CALL_FUNCPTR, op) {}
+    PSNodeCall(PSNodeSlot slot, PSNode *op)
+            : PSNode(slot, PSNodeType::CALL_FUNCPTR, op) {}
 
     static PSNodeCall *get(PSNode *n) {
         return (isa<PSNodeType::CALL>(n) || isa<PSNodeType::CALL_FUNCPTR>(n))
@@ -519,8 +532,9 @@ class PSNodeCallRet : public PSNode {
 
   public:
     template <typename... Args>
-    PSNodeCallRet(IDType id, Args &&...args)
-            : PSNode(id, PSNodeType::CALL_RETURN, std::forward<Args>(args)...) {
+    PSNodeCallRet(PSNodeSlot slot, Args &&...args)
+            : PSNode(slot, PSNodeType::CALL_RETURN,
+                     std::forward<Args>(args)...) {
     }
 
     static PSNodeCallRet *get(PSNode *n) {
@@ -571,8 +585,8 @@ class PSNodeRet : public PSNode {
 
   public:
     template <typename... Args>
-    PSNodeRet(IDType id, Args &&...args)
-            : PSNode(id, PSNodeType::RETURN, std::forward<Args>(args)...) {}
+    PSNodeRet(PSNodeSlot slot, Args &&...args)
+            : PSNode(slot, PSNodeType::RETURN, std::forward<Args>(args)...) {}
 
     static PSNodeRet *get(PSNode *n) {
         return isa<PSNodeType::RETURN>(n) ? static_cast<PSNodeRet *>(n)
@@ -619,7 +633,8 @@ class PSNodeFork : public PSNode {
     std::set<PSNode *> functions_;
 
   public:
-    PSNodeFork(IDType id, PSNode *from) : PSNode(id, PSNodeType::FORK, from) {}
+    PSNodeFork(PSNodeSlot slot, PSNode *from)
+            : PSNode(slot, PSNodeType::FORK, from) {}
 
     static PSNodeFork *get(PSNode *n) {
         return isa<PSNodeType::FORK>(n) ? static_cast<PSNodeFork *>(n)
@@ -648,7 +663,7 @@ class PSNodeJoin : public PSNode {
     std::set<PSNode *> functions_;
 
   public:
-    PSNodeJoin(IDType id) : PSNode(id, PSNodeType::JOIN) {}
+    PSNodeJoin(PSNodeSlot slot) : PSNode(slot, PSNodeType::JOIN) {}
 
     static PSNodeJoin *get(PSNode *n) {
         return isa<PSNodeType::JOIN>(n) ? static_cast<PSNodeJoin *>(n)
@@ -2,6 +2,9 @@
 #define DG_POINTER_ANALYSIS_H_
 
 #include <cassert>
+#include <chrono>
+#include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -14,6 +17,8 @@
 namespace dg {
 namespace pta {
 
+class DemandDrivenPointerAnalysis;
+
 class PointerAnalysis {
     static void initPointerAnalysis() {}
 
@@ -153,12 +158,47 @@ class PointerAnalysis {
         return false;
     }
 
+    // the number of nodes that were set to point to unknown memory
+    // because the analysis ran out of its time or memory budget
+    size_t getDegradedNodesNum() const { return _degradedNodes; }
+    bool exceededBudget() const { return _degradedNodes > 0; }
+
+    // objects that were collapsed to Offset::UNKNOWN because
+    // they exceeded PointerAnalysisOptions::maxObjectOffsets
+    const std::vector<PSNode *> &getCollapsedObjects() const {
+        return _collapsedObjects;
+    }
+
     // handle join of threads
     // FIXME: this should be done in the generic pointer analysis,
     // we do not need to pass this to the LLVM part...
     virtual bool handleJoin(PSNode * /*unused*/) { return false; }
 
   private:
+    friend class DemandDrivenPointerAnalysis;
+
+    // distinct offsets of pointers into the objects (tracked only
+    // when maxObjectOffsets is set and only until the object collapses)
+    struct ObjectOffsets {
+        std::set<Offset> offsets;
+        bool collapsed{false};
+    };
+
+    std::unordered_map<const PSNode *, ObjectOffsets> _objectOffsets;
+    std::vector<PSNode *> _collapsedObjects;
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point _startTime;
+    size_t _degradedNodes{0};
+
+    bool isOverBudget() const;
+    void resolvePendingCalls(std::vector<PSNode *> &nodes);
+    void degradeToUnknown(std::vector<PSNode *> &nodes);
+
+    // return the offset that should be used for a pointer
+    // into 'target' with the offset 'off'
+    Offset boundOffset(PSNode *target, Offset off);
+
     // check the sanity of results of pointer analysis
     void sanityCheck();
 
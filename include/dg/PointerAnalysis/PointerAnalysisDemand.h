@@ -0,0 +1,72 @@
+#ifndef DG_POINTER_ANALYSIS_DEMAND_H_
+#define DG_POINTER_ANALYSIS_DEMAND_H_
+
+#include <vector>
+
+#include "PointerAnalysis.h"
+
+namespace dg {
+namespace pta {
+
+///
+// Demand-driven solving of a flow-insensitive pointer analysis.
+// Instead of processing the whole graph from the entry, we process
+// only the nodes that the queried nodes (transitively) depend on:
+// their operands and the stores (memcpys) that may write to memory
+// that is read by the relevant loads. To find the stores, we first
+// demand the pointer operand of every store and only if it may point
+// to memory read by a relevant load, we demand the whole store
+// (a simple form of the CFL-reachability refinement).
+//
+// The points-to sets of the demanded nodes are the same as they
+// would be after running the whole analysis (modulo the nodes
+// unreachable from the entry, that the whole analysis skips).
+// Points-to sets of other nodes are incomplete.
+// The queries can be repeated, the solved part of the graph is reused.
+class DemandDrivenPointerAnalysis {
+    PointerAnalysis &PTA;
+    // the maximal number of demanded nodes (0 = no limit)
+    size_t maxNodes;
+
+    std::vector<bool> demanded;
+    std::vector<PSNode *> relevant;
+    // relevant nodes that read memory
+    std::vector<PSNode *> readers;
+    // nodes that write memory and that are not relevant yet
+    std::vector<PSNode *> writers;
+    // the number of nodes of the graph that we have already seen
+    size_t scannedNodes{0};
+
+    bool initialized{false};
+    bool exhausted{false};
+
+    void initialize();
+    void scanNewNodes(std::vector<PSNode *> &worklist);
+    bool demand(std::vector<PSNode *> &worklist);
+    void solve();
+    void demandOperands(std::vector<PSNode *> &worklist);
+    void demandWriters(std::vector<PSNode *> &worklist);
+
+  public:
+    DemandDrivenPointerAnalysis(PointerAnalysis &pta, size_t maxNodes = 0)
+            : PTA(pta), maxNodes(maxNodes) {}
+
+    ///
+    // Compute the points-to sets of the given nodes. Returns false
+    // if the query needs more than 'maxNodes' nodes. In that case,
+    // the points-to sets are not complete and the caller should
+    // fall back to running the whole analysis.
+    bool query(const std::vector<PSNode *> &nodes);
+
+    bool isSolved(const PSNode *nd) const {
+        return !exhausted && nd->getID() < demanded.size() &&
+               demanded[nd->getID()];
+    }
+
+    size_t getDemandedNodesNum() const { return relevant.size(); }
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif
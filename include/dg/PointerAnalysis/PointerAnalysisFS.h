@@ -25,7 +25,6 @@ class PointerAnalysisFS : public PointerAnalysis {
         assert(opts.preprocessGeps == false &&
                "Preprocessing GEPs does not work correctly for FS analysis");
         memoryMaps.reserve(ps->size() / 5);
-        ps->computeLoops();
     }
 
     PointerAnalysisFS(PointerGraph *ps) : PointerAnalysisFS(ps, {}) {}
@@ -114,12 +113,6 @@ class PointerAnalysisFS : public PointerAnalysis {
         return changed;
     }
 
-    bool functionPointerCall(PSNode * /*unused*/,
-                             PSNode * /*unused*/) override {
-        PG->computeLoops();
-        return false;
-    }
-
     void getMemoryObjects(PSNode *where, const Pointer &pointer,
                           std::vector<MemoryObject *> &objects) override {
         MemoryMapT *mm = where->getData<MemoryMapT>();
@@ -205,7 +198,16 @@ class PointerAnalysisFS : public PointerAnalysis {
         return mm;
     }
 
-    static bool isOnLoop(const PSNode *n) {
+    // the loops of a subgraph are computed on the first query, so
+    // subgraphs added by resolving calls via function pointers do not
+    // trigger recomputation of loops in the whole graph.
+    // NOTE: we do not batch the resolved calls until the end of an
+    // iteration. Resolving a call only builds and connects the called
+    // subgraph, there is nothing global left to share between the calls,
+    // and a deferred call would keep its CFG edge to the return site
+    // for the rest of the iteration, so the memory from before the call
+    // would be merged to the return site (losing strong updates).
+    static bool isOnLoop(PSNode *n) {
         // if the scc's size > 1, the node is in loop
         return n->getParent() ? (n->getParent()->getLoop(n) != nullptr) : false;
     }
@@ -238,7 +238,7 @@ class PointerAnalysisFSInv : public PointerAnalysisFS {
     // return true if we know the instance of the object
     // (allocations in loop or recursive calls may have
     // multiple instances)
-    static bool knownInstance(const PSNode *node) { return !isOnLoop(node); }
+    static bool knownInstance(PSNode *node) { return !isOnLoop(node); }
 
     static bool invStrongUpdate(const PSNode *operand) {
         // If we are freeing memory through node that
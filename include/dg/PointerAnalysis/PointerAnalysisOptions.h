@@ -18,10 +18,28 @@ struct PointerAnalysisOptions : AnalysisOptions {
     // INVALIDATED object.
     bool invalidateNodes{false};
 
+    // Collapse nodes that provably have the same points-to set
+    // (offline variable substitution) before running the analysis
+    bool mergeEquivalentPointers{false};
+
+    // Collapse an object to Offset::UNKNOWN once pointers with more
+    // than this number of distinct offsets point into it (0 means
+    // no limit). This bounds the size of points-to sets for array-like
+    // objects while keeping the field sensitivity for small structures.
+    size_t maxObjectOffsets{0};
+
     PointerAnalysisOptions &setInvalidateNodes(bool b) {
         invalidateNodes = b;
         return *this;
     }
+    PointerAnalysisOptions &setMergeEquivalentPointers(bool b) {
+        mergeEquivalentPointers = b;
+        return *this;
+    }
+    PointerAnalysisOptions &setMaxObjectOffsets(size_t n) {
+        maxObjectOffsets = n;
+        return *this;
+    }
     PointerAnalysisOptions &setPreprocessGeps(bool b) {
         preprocessGeps = b;
         return *this;
@@ -31,6 +49,20 @@ struct PointerAnalysisOptions : AnalysisOptions {
     // If exceeded, the analysis is terminated and points-to sets
     // of the unprocessed nodes are set to {}.
     size_t maxIterations{0};
+
+    // Stop the analysis after this number of milliseconds (0 means
+    // no limit). Unlike with maxIterations, the results stay sound:
+    // the unprocessed nodes get the unknown pointer.
+    unsigned timeout{0};
+
+    // Stop the analysis the same way when the resident memory
+    // of the process exceeds this number of MB (0 means no limit).
+    size_t maxMemory{0};
+
+    // The maximal number of nodes that a demand-driven query
+    // may process before we fall back to the whole analysis
+    // (0 means no limit).
+    size_t maxDemandedNodes{0};
 };
 
 } // namespace dg
@@ -1,6 +1,7 @@
 #ifndef DG_POINTER_GRAPH_H_
 #define DG_POINTER_GRAPH_H_
 
+#include "dg/ADT/Arena.h"
 #include "dg/ADT/Queue.h"
 #include "dg/BFS.h"
 #include "dg/CallGraph/CallGraph.h"
@@ -69,6 +70,14 @@ class PointerSubgraph {
         return it == _node_to_loop.end() ? nullptr : &_loops[it->second];
     }
 
+    // compute the loops if they have not been computed yet, so that
+    // subgraphs that are never queried do not pay for it
+    const std::vector<PSNode *> *getLoop(const PSNode *nd) {
+        if (!computedLoops())
+            computeLoops();
+        return static_cast<const PointerSubgraph *>(this)->getLoop(nd);
+    }
+
     const std::vector<std::vector<PSNode *>> &getLoops() const {
         assert(_computed_loops && "Call computeLoops() first");
         return _loops;
@@ -96,22 +105,47 @@ enum PointerGraphReservedIDs {
 // Basic graph for pointer analysis
 // -- contains CFG graphs for all procedures of the program.
 class PointerGraph {
+  public:
+    using NodesT =
+            std::vector<std::unique_ptr<PSNode, ADT::ArenaDeleter<PSNode>>>;
+
+  private:
     unsigned int dfsnum{0};
 
     // root of the pointer state subgraph
     PointerSubgraph *_entry{nullptr};
 
-    using NodesT = std::vector<std::unique_ptr<PSNode>>;
     using GlobalNodesT = std::vector<PSNode *>;
     using SubgraphsT = std::vector<std::unique_ptr<PointerSubgraph>>;
 
+    // nodes are allocated one after another in the arena, so that
+    // walking over them in the order of ids walks the memory
+    // sequentially. NOTE: the arena must be declared before 'nodes',
+    // because it must outlive the nodes.
+    ADT::Arena _nodesArena;
     NodesT nodes;
+    // the fields of nodes that the solver touches in every iteration,
+    // kept in dense arrays indexed by the ids of nodes: the points-to
+    // sets and the marks of the nodes visited by getNodes()
+    ADT::ChunkedArray<PointsToSetT> _pointsTo;
+    std::vector<unsigned> _dfsIds;
     SubgraphsT _subgraphs;
+    // subgraphs are only appended, so computeLoops() needs to
+    // look only at the subgraphs starting from this index
+    size_t _subgraphsWithLoops{0};
 
     // Take care of assigning ids to new nodes
     unsigned int last_node_id = PointerGraphReservedIDs::LAST_RESERVED_ID;
     unsigned int getNewNodeId() { return ++last_node_id; }
 
+    PSNodeSlot getNewNodeSlot() {
+        unsigned int id = getNewNodeId();
+        auto &pts = _pointsTo.emplace_back();
+        _dfsIds.push_back(0);
+        assert(_pointsTo.size() == id + 1 && _dfsIds.size() == id + 1);
+        return {id, &pts};
+    }
+
     GenericCallGraph<PSNode *> callGraph;
     GlobalNodesT _globals;
 
@@ -146,7 +180,8 @@ class PointerGraph {
               typename Node = typename GetNodeType<Type>::type>
     typename std::enable_if<!std::is_same<Node, PSNode>::value, Node *>::type
     nodeFactory(Args &&...args) {
-        return new Node(getNewNodeId(), std::forward<Args>(args)...);
+        return _nodesArena.create<Node>(getNewNodeSlot(),
+                                        std::forward<Args>(args)...);
     }
 
     // we need to check that the number of arguments is correct with general
@@ -158,7 +193,8 @@ class PointerGraph {
         static_assert(expected_args_size<Type, sizeof...(args)>() ==
                               sizeof...(args),
                       "Incorrect number of arguments");
-        return new Node(getNewNodeId(), Type, std::forward<Args>(args)...);
+        return _nodesArena.create<Node>(getNewNodeSlot(), Type,
+                                        std::forward<Args>(args)...);
     }
 
   public:
@@ -171,6 +207,12 @@ class PointerGraph {
         nodes.emplace_back(nullptr);
         nodes.emplace_back(nullptr);
         assert(nodes.size() - 1 == PointerGraphReservedIDs::LAST_RESERVED_ID);
+        // the special nodes have their own points-to sets,
+        // the dense arrays just keep the indices aligned with ids
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            _pointsTo.emplace_back();
+            _dfsIds.push_back(0);
+        }
         initStaticNodes();
     }
 
@@ -239,10 +281,14 @@ class PointerGraph {
 
         struct DfsIdTracker {
             const unsigned dfsnum;
-            DfsIdTracker(unsigned dnum) : dfsnum(dnum) {}
+            std::vector<unsigned> &dfsIds;
+            DfsIdTracker(unsigned dnum, std::vector<unsigned> &ids)
+                    : dfsnum(dnum), dfsIds(ids) {}
 
-            void visit(PSNode *n) { n->dfsid = dfsnum; }
-            bool visited(PSNode *n) const { return n->dfsid == dfsnum; }
+            void visit(PSNode *n) { dfsIds[n->getID()] = dfsnum; }
+            bool visited(PSNode *n) const {
+                return dfsIds[n->getID()] == dfsnum;
+            }
         };
 
         // iterate over successors and call (return) edges
@@ -277,7 +323,7 @@ class PointerGraph {
             }
         };
 
-        DfsIdTracker visitTracker(dfsnum);
+        DfsIdTracker visitTracker(dfsnum, _dfsIds);
         EdgeChooser chooser(interprocedural);
         BFS<PSNode, DfsIdTracker, EdgeChooser> bfs(visitTracker, chooser);
 
@@ -1,6 +1,9 @@
 #ifndef DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 #define DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 
+#include <unordered_set>
+#include <vector>
+
 #include "PointsToMapping.h"
 
 namespace dg {
@@ -73,6 +76,45 @@ class PSEquivalentNodesMerger {
     unsigned merged_nodes_num;
 };
 
+// Offline variable substitution: find nodes that provably have the same
+// points-to set (hash-based value numbering over CAST, GEP, PHI, CONSTANT
+// and -- for flow-insensitive analysis -- LOAD nodes) and collapse each
+// equivalence class into one representant before the analysis runs.
+class PSEquivalentPointersMerger {
+  public:
+    using MappingT = PointsToMapping<PSNode *>;
+
+    PSEquivalentPointersMerger(PointerGraph *g, bool mergeLoads = false)
+            : G(g), mergeLoads(mergeLoads) {}
+
+    // nodes that may get new operands during the analysis
+    // (e.g., formal arguments). These are never removed.
+    void addOpenNode(PSNode *n) { open.insert(n); }
+
+    MappingT &getMapping() { return mapping; }
+    const MappingT &getMapping() const { return mapping; }
+
+    unsigned getNumOfMergedNodes() const { return merged_nodes_num; }
+
+    unsigned run();
+
+  private:
+    PointerGraph *G;
+    bool mergeLoads;
+    std::unordered_set<PSNode *> open;
+    // union-find over node IDs
+    std::vector<PSNode *> repr;
+    MappingT mapping;
+
+    unsigned merged_nodes_num{0};
+
+    PSNode *find(PSNode *n);
+    bool canBeMerged(PSNode *n) const;
+    // one round of value numbering, return true if some nodes were merged
+    bool numberNodes();
+    void applyMerges();
+};
+
 class PointerGraphOptimizer {
     using MappingT = PointsToMapping<PSNode *>;
 
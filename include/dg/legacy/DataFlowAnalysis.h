@@ -1,8 +1,12 @@
 #ifndef DG_DATA_FLOW_ANALYSIS_H_
 #define DG_DATA_FLOW_ANALYSIS_H_
 
+#include <algorithm>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "dg/legacy/Analysis.h"
 #include "dg/legacy/DFS.h"
@@ -23,6 +27,10 @@ struct DataFlowStatistics : public AnalysisStatistics {
 enum DataFlowAnalysisFlags {
     DATAFLOW_INTERPROCEDURAL = 1 << 0,
     DATAFLOW_BB_NO_CALLSITES = 1 << 1,
+    // after the first pass, run all the blocks again while anything
+    // changes (the default is to run only the blocks that depend
+    // on the changed blocks)
+    DATAFLOW_SWEEP = 1 << 2,
 };
 
 // ordering of nodes with respect to DFS order
@@ -54,7 +62,8 @@ class BBlockDataFlowAnalysis : public Analysis<NodeT> {
             flg |= DFS_BB_NO_CALLSITES;
 
         BBlockDFS<NodeT> DFS(flg);
-        DFSDataT data(blocks, changed, this);
+        std::vector<BBlock<NodeT> *> changedBlocks;
+        DFSDataT data(blocks, changedBlocks, changed, this);
 
         // we will get all the nodes using DFS
         DFS.run(entryBB, dfs_proc_bb, data);
@@ -65,20 +74,10 @@ class BBlockDataFlowAnalysis : public Analysis<NodeT> {
         // first run goes over each BB once
         statistics.processedBlocks = statistics.bblocksNum;
 
-        // Iterate over the nodes in dfs reverse order, it is
-        // usually good for reaching fixpoint. Later we can
-        // add options what ordering to use.
-        // Since we used while loop, if nothing changed after the
-        // first iteration (the DFS), the loop will never run
-        while (changed) {
-            changed = false;
-            for (auto I = blocks.rbegin(), E = blocks.rend(); I != E; ++I) {
-                changed |= runOnBlock(*I);
-                ++statistics.processedBlocks;
-            }
-
-            ++statistics.iterationsNum;
-        }
+        if (flags & DATAFLOW_SWEEP)
+            runSweeps();
+        else if (!changedBlocks.empty())
+            runWorklist(changedBlocks);
     }
 
     uint32_t getFlags() const { return flags; }
@@ -96,6 +95,8 @@ class BBlockDataFlowAnalysis : public Analysis<NodeT> {
     }
 
   private:
+    using BBlockPtrT = BBlock<NodeT> *;
+
     // define set of blocks to be ordered in dfs order
     // FIXME if we use dfs order, then addBB does not work,
     // because the BB's newly added does have dfsorder unset
@@ -105,19 +106,135 @@ class BBlockDataFlowAnalysis : public Analysis<NodeT> {
             NodeT> * /*,
 DFSOrderLess<BBlock<NodeT> *>*/>;
     struct DFSDataT {
-        DFSDataT(BlocksSetT &b, bool &c, BBlockDataFlowAnalysis<NodeT> *r)
-                : blocks(b), changed(c), ref(r) {}
+        DFSDataT(BlocksSetT &b, std::vector<BBlockPtrT> &cb, bool &c,
+                 BBlockDataFlowAnalysis<NodeT> *r)
+                : blocks(b), changedBlocks(cb), changed(c), ref(r) {}
 
         BlocksSetT &blocks;
+        std::vector<BBlockPtrT> &changedBlocks;
         bool &changed;
         BBlockDataFlowAnalysis<NodeT> *ref;
     };
 
-    static void dfs_proc_bb(BBlock<NodeT> *BB, DFSDataT &data) {
-        data.changed |= data.ref->runOnBlock(BB);
+    static void dfs_proc_bb(BBlockPtrT BB, DFSDataT &data) {
+        if (data.ref->runOnBlock(BB)) {
+            data.changed = true;
+            data.changedBlocks.push_back(BB);
+        }
         data.blocks.insert(BB);
     }
 
+    // Iterate over the nodes in dfs reverse order, it is
+    // usually good for reaching fixpoint. Since we used while loop,
+    // if nothing changed after the first iteration (the DFS),
+    // the loop will never run
+    void runSweeps() {
+        while (changed) {
+            changed = false;
+            for (auto I = blocks.rbegin(), E = blocks.rend(); I != E; ++I) {
+                changed |= runOnBlock(*I);
+                ++statistics.processedBlocks;
+            }
+
+            ++statistics.iterationsNum;
+        }
+    }
+
+    // the blocks that the DFS went to from 'BB'
+    template <typename FuncT>
+    void forEachSuccessor(BBlockPtrT BB, FuncT func) const {
+        for (auto &E : BB->successors())
+            func(E.target);
+
+        if (!(flags & DATAFLOW_INTERPROCEDURAL))
+            return;
+        for (NodeT *cs : BB->getCallSites()) {
+            for (auto *subdg : cs->getSubgraphs())
+                func(subdg->getEntryBB());
+        }
+    }
+
+    // Run again only the blocks whose input may have changed: the
+    // successors of the changed blocks, the entry blocks of the called
+    // functions and the call sites of the functions whose exit block
+    // changed. The blocks are processed in reverse post-order,
+    // so that a block usually runs after all its predecessors.
+    void runWorklist(const std::vector<BBlockPtrT> &changedBlocks) {
+        // number the blocks in reverse post-order
+        std::unordered_map<BBlockPtrT, unsigned> rpo;
+        std::vector<BBlockPtrT> order;
+        std::unordered_map<BBlockPtrT, std::vector<BBlockPtrT>> callers;
+        {
+            std::unordered_set<BBlockPtrT> visited{entryBB};
+            std::vector<std::pair<BBlockPtrT, std::vector<BBlockPtrT>>>
+                    stack;
+            auto push = [this, &stack, &callers](BBlockPtrT BB) {
+                std::vector<BBlockPtrT> succs;
+                forEachSuccessor(BB, [&succs](BBlockPtrT S) {
+                    succs.push_back(S);
+                });
+                if (flags & DATAFLOW_INTERPROCEDURAL) {
+                    for (NodeT *cs : BB->getCallSites()) {
+                        for (auto *subdg : cs->getSubgraphs()) {
+                            if (auto *exitBB = subdg->getExitBB())
+                                callers[exitBB].push_back(BB);
+                        }
+                    }
+                }
+                // pop the successors from the back in the original order
+                std::reverse(succs.begin(), succs.end());
+                stack.emplace_back(BB, std::move(succs));
+            };
+
+            push(entryBB);
+            while (!stack.empty()) {
+                auto &succs = stack.back().second;
+                if (succs.empty()) {
+                    order.push_back(stack.back().first);
+                    stack.pop_back();
+                    continue;
+                }
+
+                BBlockPtrT S = succs.back();
+                succs.pop_back();
+                if (visited.insert(S).second)
+                    push(S);
+            }
+
+            std::reverse(order.begin(), order.end());
+            for (unsigned i = 0; i < order.size(); ++i)
+                rpo[order[i]] = i;
+        }
+
+        std::set<unsigned> queue;
+        auto enqueueDependent = [&](BBlockPtrT BB) {
+            forEachSuccessor(BB, [&](BBlockPtrT S) {
+                auto it = rpo.find(S);
+                if (it != rpo.end())
+                    queue.insert(it->second);
+            });
+
+            auto it = callers.find(BB);
+            if (it != callers.end()) {
+                for (BBlockPtrT C : it->second)
+                    queue.insert(rpo[C]);
+            }
+        };
+
+        for (BBlockPtrT BB : changedBlocks)
+            enqueueDependent(BB);
+
+        while (!queue.empty()) {
+            BBlockPtrT BB = order[*queue.begin()];
+            queue.erase(queue.begin());
+
+            ++statistics.processedBlocks;
+            if (runOnBlock(BB))
+                enqueueDependent(BB);
+        }
+        changed = false;
+    }
+
     BBlock<NodeT> *entryBB;
     BlocksSetT blocks;
     uint32_t flags;
@@ -1,9 +1,13 @@
 #ifndef DG_LLVM_CALLGRAPH_H_
 #define DG_LLVM_CALLGRAPH_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include <llvm/ADT/Hashing.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Module.h>
@@ -41,17 +45,44 @@ class CallGraphImpl {
     virtual FuncVec callees(const llvm::Function *) = 0;
     virtual bool calls(const llvm::Function *, const llvm::Function *) = 0;
 
+    // The same as callers() and callees(), but the implementations
+    // that keep the vectors return them without copying. Otherwise,
+    // the result is valid only until the next call of these methods.
+    virtual const FuncVec &getCallers(const llvm::Function *F) {
+        _result = callers(F);
+        return _result;
+    }
+
+    virtual const FuncVec &getCallees(const llvm::Function *F) {
+        _result = callees(F);
+        return _result;
+    }
+
     // trigger building the CG (can be used to force building when CG is
     // constructed on demand)
     virtual void build() {}
+
+  private:
+    FuncVec _result;
 };
 
 ///
-/// Callgraph that re-uses the Call graph built during pointer analysis from DG
+/// Callgraph that re-uses the Call graph built during pointer analysis from DG.
+/// The callers and callees of the functions are gathered when the object
+/// is constructed, so the call graph of DG must not change afterwards.
 ///
 class DGCallGraphImpl : public CallGraphImpl {
+    using FuncNode = GenericCallGraph<PSNode *>::FuncNode;
+
+    struct FuncInfo {
+        const FuncNode *node;
+        FuncVec callers;
+        FuncVec callees;
+    };
+
     const GenericCallGraph<PSNode *> &_cg;
-    std::map<const llvm::Function *, PSNode *> _mapping;
+    std::vector<FuncInfo> _funs;
+    dg::HashMap<const llvm::Function *, const FuncInfo *> _mapping;
 
     static const llvm::Function *getFunFromNode(PSNode *n) {
         auto *f = n->getUserData<llvm::Function>();
@@ -59,56 +90,69 @@ class DGCallGraphImpl : public CallGraphImpl {
         return f;
     }
 
+    const FuncInfo *getInfo(const llvm::Function *F) const {
+        auto it = _mapping.find(F);
+        return it == _mapping.end() ? nullptr : it->second;
+    }
+
+    static FuncVec toFuncVec(const std::vector<FuncNode *> &nodes) {
+        FuncVec ret;
+        ret.reserve(nodes.size());
+        for (auto *nd : nodes) {
+            ret.push_back(getFunFromNode(nd->getValue()));
+        }
+        return ret;
+    }
+
+    static const FuncVec &_empty() {
+        static const FuncVec empty;
+        return empty;
+    }
+
   public:
     DGCallGraphImpl(const dg::GenericCallGraph<PSNode *> &cg) : _cg(cg) {
+        // _mapping points into _funs, so it must not reallocate
+        _funs.reserve(_cg.size());
+        _mapping.reserve(_cg.size());
         for (const auto &it : _cg) {
-            _mapping[getFunFromNode(it.first)] = it.first;
+            _funs.push_back({&it.second, toFuncVec(it.second.getCallers()),
+                             toFuncVec(it.second.getCalls())});
+            _mapping.put(getFunFromNode(it.first), &_funs.back());
         }
     }
 
     FuncVec functions() const override {
         FuncVec ret;
-        for (const auto &it : _mapping) {
-            ret.push_back(it.first);
+        ret.reserve(_cg.size());
+        for (const auto &it : _cg) {
+            ret.push_back(getFunFromNode(it.first));
         }
         return ret;
     }
 
     FuncVec callers(const llvm::Function *F) override {
-        FuncVec ret;
-        auto it = _mapping.find(F);
-        if (it == _mapping.end())
-            return ret;
-        const auto *fnd = _cg.get(it->second);
-        for (auto *nd : fnd->getCallers()) {
-            ret.push_back(getFunFromNode(nd->getValue()));
-        }
-        return ret;
+        return getCallers(F);
     }
 
     FuncVec callees(const llvm::Function *F) override {
-        FuncVec ret;
-        auto it = _mapping.find(F);
-        if (it == _mapping.end())
-            return ret;
-        const auto *fnd = _cg.get(it->second);
-        for (auto *nd : fnd->getCalls()) {
-            ret.push_back(getFunFromNode(nd->getValue()));
-        }
-        return ret;
+        return getCallees(F);
+    }
+
+    const FuncVec &getCallers(const llvm::Function *F) override {
+        const auto *info = getInfo(F);
+        return info ? info->callers : _empty();
+    }
+
+    const FuncVec &getCallees(const llvm::Function *F) override {
+        const auto *info = getInfo(F);
+        return info ? info->callees : _empty();
     }
 
     bool calls(const llvm::Function *F, const llvm::Function *what) override {
-        auto it = _mapping.find(F);
-        if (it == _mapping.end())
-            return false;
-        auto it2 = _mapping.find(what);
-        if (it2 == _mapping.end())
-            return false;
-        const auto *fn1 = _cg.get(it->second);
-        const auto *fn2 = _cg.get(it2->second);
+        const auto *fn1 = getInfo(F);
+        const auto *fn2 = getInfo(what);
         if (fn1 && fn2) {
-            return fn1->calls(fn2);
+            return fn1->node->calls(fn2->node);
         }
         return false;
     };
@@ -302,11 +346,20 @@ class LazyLLVMCallGraph : public CallGraphImpl {
     using FuncVec = CallGraphImpl::FuncVec;
     // resolved function pointers
     dg::HashMap<const llvm::CallInst *, FuncVec> _funptrs;
-    std::vector<const llvm::Function *> _address_taken;
+    // address-taken functions (with their position in the module)
+    // indexed by the hash of their signature (see _signatureHash),
+    // a call may call only the functions from the buckets
+    // of its signature prefixes
+    dg::HashMap<uint64_t,
+                std::vector<std::pair<unsigned, const llvm::Function *>>>
+            _address_taken;
     bool _address_taken_initialized{false};
     // resolved callers of address-taken functions
     dg::HashMap<const llvm::Function *, std::vector<const llvm::CallInst *>>
             _callsOf;
+    // build the whole call graph at once (see build())
+    bool _eager{false};
+    bool _built{false};
 
     inline const llvm::Value *_getCalledValue(const llvm::CallInst *C) const {
 #if LLVM_VERSION_MAJOR >= 8
@@ -316,15 +369,47 @@ class LazyLLVMCallGraph : public CallGraphImpl {
 #endif
     }
 
+    // Types that callIsCompatible() may consider compatible
+    // have the same class: pointers and integers, vectors (that
+    // can be bitcasted if they have the same size) and otherwise
+    // only the same types.
+    static uint64_t _typeClass(const llvm::Type *Ty) {
+        if (isPointerOrIntegerTy(Ty))
+            return 0;
+        if (Ty->isVectorTy() || Ty->isX86_MMXTy())
+            return 1;
+#if LLVM_VERSION_MAJOR >= 12
+        if (Ty->isX86_AMXTy())
+            return 1;
+#endif
+        return llvm::hash_value(Ty);
+    }
+
+    // the hash of the return type and the types of the first
+    // 'args' parameters (or arguments of a call)
+    template <typename TypesT>
+    static uint64_t _signatureHash(const llvm::Type *RetTy,
+                                   const TypesT &types, size_t args) {
+        uint64_t hash = llvm::hash_combine(args, _typeClass(RetTy));
+        for (size_t i = 0; i < args; ++i)
+            hash = llvm::hash_combine(hash, _typeClass(types[i]));
+        return hash;
+    }
+
     void _initializeAddressTaken() {
         assert(!_address_taken_initialized);
         _address_taken_initialized = true;
 
+        unsigned pos = 0;
         for (auto &F : *_module) {
+            ++pos;
             if (F.isDeclaration())
                 continue;
             if (funHasAddressTaken(&F)) {
-                _address_taken.push_back(&F);
+                auto *FTy = F.getFunctionType();
+                auto hash = _signatureHash(F.getReturnType(), FTy->params(),
+                                           FTy->getNumParams());
+                _address_taken[hash].emplace_back(pos, &F);
             }
         }
     }
@@ -338,13 +423,39 @@ class LazyLLVMCallGraph : public CallGraphImpl {
             _initializeAddressTaken();
         assert(_address_taken_initialized);
 
-        FuncVec ret;
-        // filter out compatible functions
-        for (auto *fun : _address_taken) {
-            if (callIsCompatible(fun, C)) {
-                ret.push_back(fun);
+#if LLVM_VERSION_MAJOR >= 8
+        auto num_args = C->arg_size();
+#else
+        auto num_args = C->getNumArgOperands();
+#endif
+        std::vector<const llvm::Type *> types;
+        types.reserve(num_args);
+        for (size_t i = 0; i < num_args; ++i)
+            types.push_back(C->getArgOperand(i)->getType());
+
+        // the call may call also functions with fewer parameters
+        // (see callIsCompatible), the functions with the same
+        // hash may still be incompatible, so filter them out
+        std::vector<std::pair<unsigned, const llvm::Function *>> funs;
+        for (size_t args = 0; args <= num_args; ++args) {
+            auto it = _address_taken.find(
+                    _signatureHash(C->getType(), types, args));
+            if (it == _address_taken.end())
+                continue;
+            for (const auto &fun : it->second) {
+                if (fun.second->arg_size() == args &&
+                    callIsCompatible(fun.second, C)) {
+                    funs.push_back(fun);
+                }
             }
         }
+
+        // return the functions in the order of the module
+        std::sort(funs.begin(), funs.end());
+        FuncVec ret;
+        ret.reserve(funs.size());
+        for (const auto &fun : funs)
+            ret.push_back(fun.second);
         return ret;
     }
 
@@ -448,9 +559,47 @@ class LazyLLVMCallGraph : public CallGraphImpl {
         return _callsOf[F];
     }
 
+    // resolve all the calls in the module in one pass and store
+    // the calls of address-taken functions on the way, so that
+    // the queries do not need to go over the module again
+    void _buildAll() {
+        dg::HashMap<const llvm::Function *, bool> addressTaken;
+        auto hasAddressTaken = [&addressTaken](const llvm::Function *F) {
+            auto it = addressTaken.find(F);
+            if (it != addressTaken.end())
+                return it->second;
+            return addressTaken[F] = funHasAddressTaken(F);
+        };
+
+        for (auto &F : *_module) {
+            if (F.isDeclaration())
+                continue;
+            _cg.createNode(&F);
+            if (hasAddressTaken(&F))
+                _callsOf[&F];
+
+            for (auto &B : F) {
+                for (auto &I : B) {
+                    auto *C = llvm::dyn_cast<llvm::CallInst>(&I);
+                    if (!C)
+                        continue;
+                    for (auto *calledf : getCalledFunctions(C)) {
+                        if (hasAddressTaken(calledf))
+                            _callsOf[calledf].push_back(C);
+                    }
+                }
+            }
+        }
+    }
+
   public:
-    LazyLLVMCallGraph(const llvm::Module *m, LLVMPointerAnalysis *pta = nullptr)
-            : _module(m), _pta(pta) {}
+    ///
+    /// \param eager   build() builds the call graph of the whole
+    ///                 module (also with pointer analysis) in one pass,
+    ///                 use when the whole graph is going to be queried
+    LazyLLVMCallGraph(const llvm::Module *m, LLVMPointerAnalysis *pta = nullptr,
+                      bool eager = false)
+            : _module(m), _pta(pta), _eager(eager) {}
 
     // TODO: add this method to general interface?
     const FuncVec &getCalledFunctions(const llvm::CallInst *C) {
@@ -508,7 +657,9 @@ class LazyLLVMCallGraph : public CallGraphImpl {
         getCallsOf(F);
 
         auto fnd = _cg.get(F);
-        assert(fnd);
+        // no one calls F
+        if (!fnd)
+            return ret;
         for (auto *nd : fnd->getCallers()) {
             ret.push_back(nd->getValue());
         }
@@ -541,7 +692,11 @@ class LazyLLVMCallGraph : public CallGraphImpl {
 
     // trigger build
     void build() override {
-        if (_pta) { // build only reachable functions
+        if (_eager) {
+            if (!_built)
+                _buildAll();
+            _built = true;
+        } else if (_pta) { // build only reachable functions
             auto *entry =
                     _module->getFunction(_pta->getOptions().entryFunction);
             assert(entry && "Entry function not found");
@@ -574,12 +729,14 @@ class CallGraph {
 
     CallGraph(GenericCallGraph<PSNode *> &cg)
             : _impl(new DGCallGraphImpl(cg)) {}
-    CallGraph(const llvm::Module *m, LLVMPointerAnalysis *pta, bool lazy = true)
+    CallGraph(const llvm::Module *m, LLVMPointerAnalysis *pta, bool lazy = true,
+              bool eager = false)
             : _impl(lazy ? static_cast<CallGraphImpl *>(
-                                   new LazyLLVMCallGraph(m, pta))
+                                   new LazyLLVMCallGraph(m, pta, eager))
                          : static_cast<CallGraphImpl *>(
                                    new LLVMPTACallGraphImpl(m, pta))) {}
-    CallGraph(const llvm::Module *m) : _impl(new LazyLLVMCallGraph(m)) {}
+    CallGraph(const llvm::Module *m, bool eager = false)
+            : _impl(new LazyLLVMCallGraph(m, nullptr, eager)) {}
 
     ///
     /// Get all functions in this call graph
@@ -594,6 +751,16 @@ class CallGraph {
     ///
     FuncVec callees(const llvm::Function *F) { return _impl->callees(F); };
     ///
+    /// The same as callers() and callees(), but without copying
+    /// the functions if possible (see CallGraphImpl::getCallers())
+    ///
+    const FuncVec &getCallers(const llvm::Function *F) {
+        return _impl->getCallers(F);
+    }
+    const FuncVec &getCallees(const llvm::Function *F) {
+        return _impl->getCallees(F);
+    }
+    ///
     /// Return true if function 'F' calls 'what'
     ///
     bool calls(const llvm::Function *F, const llvm::Function *what) {
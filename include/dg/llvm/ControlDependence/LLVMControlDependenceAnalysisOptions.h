@@ -10,6 +10,10 @@ struct LLVMControlDependenceAnalysisOptions : public LLVMAnalysisOptions,
                                               ControlDependenceAnalysisOptions {
     bool _nodePerInstruction{false};
     bool _icfg{false};
+    // the number of threads that compute the post-dominators
+    // of functions for the standard CD in LLVMDependenceGraph
+    // (0 means the number of CPUs)
+    unsigned workers{1};
 
     void setNodePerInstruction(bool b) { _nodePerInstruction = b; }
     bool nodePerInstruction() const { return _nodePerInstruction; }
@@ -0,0 +1,21 @@
+#ifndef DG_LLVMDG2BINARY_H_
+#define DG_LLVMDG2BINARY_H_
+
+#include <string>
+
+#include "dg/BinaryGraph.h"
+
+namespace dg {
+
+class LLVMDependenceGraph;
+
+///
+// Store the graphs of all the constructed functions in the module
+// of 'dg' into a file in the binary format (see dg/BinaryGraph.h).
+// The control dependencies between blocks are stored as edges
+// from the terminator of the block to all nodes of the dependent block.
+bool writeBinaryGraph(LLVMDependenceGraph *dg, const std::string &path);
+
+} // namespace dg
+
+#endif // DG_LLVMDG2BINARY_H_
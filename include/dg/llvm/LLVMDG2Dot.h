@@ -5,10 +5,12 @@
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include "dg/DG2Dot.h"
 #include "dg/llvm/LLVMDependenceGraph.h"
 #include "dg/llvm/LLVMNode.h"
+#include "dg/llvm/LLVMValueFormatter.h"
 
 #if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR <= 4))
 #include "llvm/DebugInfo.h" //DIScope
@@ -33,14 +35,13 @@ static std::ostream& operator<<(std::ostream& os, const analysis::Offset& off)
 */
 
 namespace {
-inline std::ostream &printLLVMVal(std::ostream &os, const llvm::Value *val) {
-    if (!val) {
-        os << "(null)";
-        return os;
-    }
+inline std::string getLLVMValDotLabel(const llvm::Value *val,
+                                      LLVMValueFormatter &formatter) {
+    if (!val)
+        return "(null)";
 
-    std::ostringstream ostr;
-    llvm::raw_os_ostream ro(ostr);
+    std::string str;
+    llvm::raw_string_ostream ro(str);
 
     if (llvm::isa<llvm::Function>(val)) {
         ro << "FUNC " << val->getName();
@@ -54,15 +55,14 @@ inline std::ostream &printLLVMVal(std::ostream &os, const llvm::Value *val) {
         } else {
             ro << "<null>::\n";
         }
-        ro << *val;
+        formatter.print(ro, val);
     } else {
-        ro << *val;
+        formatter.print(ro, val);
     }
 
     ro.flush();
 
     // break the string if it is too long
-    std::string str = ostr.str();
     if (str.length() > 100) {
         str.resize(40);
     }
@@ -75,8 +75,12 @@ inline std::ostream &printLLVMVal(std::ostream &os, const llvm::Value *val) {
         pos += 2;
     }
 
-    os << str;
+    return str;
+}
 
+inline std::ostream &printLLVMVal(std::ostream &os, const llvm::Value *val) {
+    LLVMValueFormatter formatter;
+    os << getLLVMValDotLabel(val, formatter);
     return os;
 }
 } // anonymous namespace
@@ -92,7 +96,13 @@ class LLVMDG2Dot : public debug::DG2Dot<LLVMNode> {
 
     /* virtual */
     std::ostream &printKey(std::ostream &os, llvm::Value *val) override {
-        return printLLVMVal(os, val);
+        // every node is printed more times (in its block and
+        // in the subgraph), format the value only once
+        auto it = labels.find(val);
+        if (it == labels.end())
+            it = labels.emplace(val, getLLVMValDotLabel(val, formatter)).first;
+        os << it->second;
+        return os;
     }
 
     /* virtual */
@@ -191,6 +201,9 @@ class LLVMDG2Dot : public debug::DG2Dot<LLVMNode> {
     }
 
   private:
+    LLVMValueFormatter formatter;
+    std::unordered_map<const llvm::Value *, std::string> labels;
+
     void dumpSubgraph(LLVMDependenceGraph *graph, const char *name) {
         dumpSubgraphStart(graph, name);
 
@@ -0,0 +1,251 @@
+#ifndef DG_LLVMDG2EDGELIST_H_
+#define DG_LLVMDG2EDGELIST_H_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "dg/DG2Dot.h"
+#include "dg/EdgeListWriter.h"
+#include "dg/llvm/LLVMDependenceGraph.h"
+#include "dg/llvm/LLVMValueFormatter.h"
+#include "dg/llvm/LLVMNode.h"
+
+namespace dg {
+namespace debug {
+
+// the full (not shortened) text of the value
+inline std::string getLLVMValueLabel(const llvm::Value *val,
+                                     LLVMValueFormatter &formatter) {
+    if (!val)
+        return "(null)";
+
+    std::string str;
+    if (llvm::isa<llvm::Function>(val)) {
+        str = "FUNC " + val->getName().str();
+    } else if (llvm::isa<llvm::BasicBlock>(val)) {
+        str = "label " + val->getName().str();
+    } else {
+        str = formatter.format(val);
+    }
+
+    // instructions are printed with indentation
+    auto pos = str.find_first_not_of(' ');
+    if (pos != std::string::npos && pos > 0)
+        str.erase(0, pos);
+    return str;
+}
+
+///
+// Dump the dependence graph as a list of nodes and edges
+// (see EdgeListWriter). Which edges are dumped is driven
+// by the same options as in DG2Dot.
+class LLVMDG2EdgeList {
+    using ContainerType = LLVMDependenceGraph::ContainerType;
+    using FunctionsT =
+            std::vector<std::pair<llvm::Function *, LLVMDependenceGraph *>>;
+
+    uint32_t options;
+    EdgeListWriter writer;
+    LLVMValueFormatter formatter;
+    std::unordered_map<const LLVMNode *, unsigned> ids;
+    std::set<const ContainerType *> dumpedGlobals;
+
+    unsigned getID(const LLVMNode *n) {
+        auto &id = ids[n];
+        if (id == 0)
+            id = ids.size();
+        return id;
+    }
+
+    // functions in the order of the module, so that the numbering
+    // does not depend on the addresses of the objects
+    static FunctionsT getFunctions(const char *only_func) {
+        FunctionsT ret;
+        const auto &CF = getConstructedFunctions();
+        if (CF.empty())
+            return ret;
+
+        auto *M = llvm::cast<llvm::Function>(CF.begin()->first)->getParent();
+        for (auto &F : *M) {
+            if (only_func && !F.getName().equals(only_func))
+                continue;
+            auto it = CF.find(&F);
+            if (it != CF.end())
+                ret.emplace_back(&F, it->second);
+        }
+        return ret;
+    }
+
+    template <typename Fun>
+    static void forEachParam(DGParameters<LLVMNode> *params, Fun fun) {
+        if (!params)
+            return;
+
+        for (auto &it : *params) {
+            fun(it.second.in);
+            fun(it.second.out);
+        }
+        for (auto I = params->global_begin(), E = params->global_end(); I != E;
+             ++I) {
+            fun(I->second.in);
+            fun(I->second.out);
+        }
+        if (auto *va = params->getVarArg()) {
+            fun(va->in);
+            fun(va->out);
+        }
+        fun(params->getNoReturn());
+    }
+
+    // all nodes of the graph, including parameters
+    // and the artificial unified exit node
+    template <typename Fun>
+    void forEachNode(LLVMDependenceGraph *graph, Fun fun) {
+        forEachParam(graph->getParameters(), fun);
+        for (auto &I : *graph) {
+            fun(I.second);
+            forEachParam(I.second->getParameters(), fun);
+        }
+        if (auto *exit = graph->getExit()) {
+            if (!graph->getNode(exit->getKey()))
+                fun(exit);
+        }
+    }
+
+    void dumpNode(LLVMNode *node, const std::string &fun) {
+        if (node)
+            writer.node(getID(node), fun, getLLVMValueLabel(node->getKey(), formatter));
+    }
+
+    void dumpNodeEdges(LLVMNode *n) {
+        if (!n)
+            return;
+
+        auto id = getID(n);
+        if (options & PRINT_DD) {
+            for (auto II = n->data_begin(), EE = n->data_end(); II != EE; ++II)
+                writer.edge(id, getID(*II), "dd");
+        }
+        if (options & PRINT_USE) {
+            for (auto II = n->use_begin(), EE = n->use_end(); II != EE; ++II)
+                writer.edge(id, getID(*II), "use");
+        }
+        if (options & PRINT_CD) {
+            for (auto II = n->control_begin(), EE = n->control_end(); II != EE;
+                 ++II)
+                writer.edge(id, getID(*II), "cd");
+        }
+        if (options & PRINT_ID) {
+            for (auto II = n->interference_begin(), EE = n->interference_end();
+                 II != EE; ++II)
+                writer.edge(id, getID(*II), "id");
+        }
+        if (options & PRINT_CALL) {
+            for (auto *subgraph : n->getSubgraphs())
+                writer.edge(id, getID(subgraph->getEntry()), "call");
+        }
+    }
+
+    void dumpBlockEdges(LLVMBBlock *BB) {
+        auto id = getID(BB->getLastNode());
+        if (options & PRINT_CFG) {
+            for (const auto &S : BB->successors())
+                writer.edge(id, getID(S.target->getFirstNode()), "cfg");
+        }
+        if (options & PRINT_CD) {
+            for (auto *S : BB->controlDependence())
+                writer.edge(id, getID(S->getFirstNode()), "cd");
+        }
+    }
+
+    void dumpGraphNodes(LLVMDependenceGraph *graph, const std::string &fun) {
+        forEachNode(graph, [&](LLVMNode *n) { dumpNode(n, fun); });
+    }
+
+    void dumpGraphEdges(LLVMDependenceGraph *graph) {
+        forEachNode(graph, [&](LLVMNode *n) { dumpNodeEdges(n); });
+        for (auto &B : graph->getBlocks()) {
+            if (!B.second->empty())
+                dumpBlockEdges(B.second);
+        }
+    }
+
+    // global nodes are shared by the graphs, get every node only once
+    std::vector<LLVMNode *> getGlobals(const FunctionsT &functions) {
+        std::vector<LLVMNode *> ret;
+        for (const auto &F : functions) {
+            const auto &globals = F.second->getGlobalNodes();
+            if (!globals || !dumpedGlobals.insert(globals.get()).second)
+                continue;
+
+            for (auto &I : *globals)
+                ret.push_back(I.second);
+        }
+        return ret;
+    }
+
+  public:
+    LLVMDG2EdgeList(EdgeListFormat format,
+                    uint32_t opts = PRINT_CFG | PRINT_DD | PRINT_CD)
+            : options(opts), writer(format) {}
+
+    // dump everything into one file (nullptr means stdout)
+    bool dump(const char *file = nullptr, const char *only_func = nullptr) {
+        if (!writer.open(file))
+            return false;
+
+        auto functions = getFunctions(only_func);
+        auto globals = getGlobals(functions);
+
+        // all the nodes must go before the edges
+        for (auto *n : globals)
+            dumpNode(n, "");
+        for (auto &F : functions)
+            dumpGraphNodes(F.second, F.first->getName().str());
+
+        for (auto *n : globals)
+            dumpNodeEdges(n);
+        for (auto &F : functions)
+            dumpGraphEdges(F.second);
+
+        writer.close();
+        return true;
+    }
+
+    // dump every function into its own file 'prefix.function.(json|csv)'
+    // and global nodes into 'prefix.globals.(json|csv)'
+    bool dumpSharded(const std::string &prefix,
+                     const char *only_func = nullptr) {
+        auto functions = getFunctions(only_func);
+        if (!writer.open((prefix + ".globals" + writer.getSuffix()).c_str()))
+            return false;
+
+        auto globals = getGlobals(functions);
+        for (auto *n : globals)
+            dumpNode(n, "");
+        for (auto *n : globals)
+            dumpNodeEdges(n);
+
+        for (auto &F : functions) {
+            auto name = F.first->getName().str();
+            if (!writer.open((prefix + "." + name + writer.getSuffix()).c_str()))
+                return false;
+            dumpGraphNodes(F.second, name);
+            dumpGraphEdges(F.second);
+        }
+
+        writer.close();
+        return true;
+    }
+};
+
+} // namespace debug
+} // namespace dg
+
+#endif // DG_LLVMDG2EDGELIST_H_
@@ -145,7 +145,10 @@ class LLVMDependenceGraph : public DependenceGraph<LLVMNode> {
     static void computeCriticalSections(ControlFlowGraph *controlFlowGraph);
 
   private:
-    void computePostDominators(bool addPostDomFrontiers = false);
+    // compute post-dominators (and frontiers) of functions
+    // using 'workers' threads (0 means the number of CPUs)
+    void computePostDominators(bool addPostDomFrontiers = false,
+                               unsigned workers = 1);
     void computeNonTerminationControlDependencies();
     void computeNTSCD(const LLVMControlDependenceAnalysisOptions &opts);
 
@@ -0,0 +1,75 @@
+#ifndef DG_LLVM_VALUE_FORMATTER_H_
+#define DG_LLVM_VALUE_FORMATTER_H_
+
+#include <memory>
+#include <string>
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalValue.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#if LLVM_VERSION_MAJOR >= 4
+#include <llvm/IR/ModuleSlotTracker.h>
+#endif
+
+namespace dg {
+
+///
+// Prints LLVM values into strings. Printing a value on its own
+// numbers all the values of the function (and the module) again
+// for every printed value, which is the most expensive part of dumping
+// big graphs. The formatter keeps one numbering for all the values.
+class LLVMValueFormatter {
+#if LLVM_VERSION_MAJOR >= 4
+    std::unique_ptr<llvm::ModuleSlotTracker> _mst;
+
+    // the module of the value or nullptr (also for values
+    // that are not inserted into the module, e.g., artificial
+    // instructions created by the dependence graph)
+    static const llvm::Module *getModule(const llvm::Value *val) {
+        const llvm::Function *F = nullptr;
+        if (const auto *I = llvm::dyn_cast<llvm::Instruction>(val)) {
+            F = I->getParent() ? I->getParent()->getParent() : nullptr;
+        } else if (const auto *A = llvm::dyn_cast<llvm::Argument>(val)) {
+            F = A->getParent();
+        } else if (const auto *B = llvm::dyn_cast<llvm::BasicBlock>(val)) {
+            F = B->getParent();
+        } else if (const auto *G = llvm::dyn_cast<llvm::GlobalValue>(val)) {
+            return G->getParent();
+        }
+        return F ? F->getParent() : nullptr;
+    }
+#endif
+
+  public:
+    void print(llvm::raw_ostream &os, const llvm::Value *val) {
+#if LLVM_VERSION_MAJOR >= 4
+        if (!_mst) {
+            if (const auto *M = getModule(val))
+                _mst.reset(new llvm::ModuleSlotTracker(M));
+        }
+
+        if (_mst && getModule(val) == _mst->getModule()) {
+            val->print(os, *_mst);
+            return;
+        }
+#endif
+        os << *val;
+    }
+
+    std::string format(const llvm::Value *val) {
+        std::string str;
+        llvm::raw_string_ostream ro(str);
+        print(ro, val);
+        ro.flush();
+        return str;
+    }
+};
+
+} // namespace dg
+
+#endif // DG_LLVM_VALUE_FORMATTER_H_
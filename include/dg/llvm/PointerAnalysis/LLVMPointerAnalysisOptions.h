@@ -1,6 +1,8 @@
 #ifndef DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 #define DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 
+#include <string>
+
 #include "dg/PointerAnalysis/PointerAnalysisOptions.h"
 #include "dg/llvm/LLVMAnalysisOptions.h"
 
@@ -12,6 +14,12 @@ struct LLVMPointerAnalysisOptions : public LLVMAnalysisOptions,
 
     bool threads{false};
 
+    // load the results of the analysis from this file (created
+    // by an earlier run on the same module) instead of solving
+    std::string loadResultsFrom{};
+    // store the results of the analysis into this file
+    std::string saveResultsTo{};
+
     bool isFS() const { return analysisType == AnalysisType::fs; }
     bool isFSInv() const { return analysisType == AnalysisType::inv; }
     bool isFI() const { return analysisType == AnalysisType::fi; }
@@ -467,6 +467,90 @@ class DGLLVMPointsToSet
     }
 };
 
+///
+// Non-owning view of the DG's points-to set with the same interface
+// as LLVMPointsToSet. Unlike LLVMPointsToSet, it does not allocate
+// anything and its iterators are not virtual, so it is cheap to create
+// and iterate. The view is valid only as long as the viewed points-to set.
+class DGLLVMPointsToView {
+    const PointsToSetT *PTSet{nullptr};
+
+  public:
+    class const_iterator {
+        using SetIt = PointsToSetT::const_iterator;
+        SetIt it;
+        SetIt end;
+
+        // skip null, unknown, etc. (nodes that have no llvm::Value)
+        void _findNextReal() {
+            while (it != end && (!(*it).isValid() || (*it).isInvalidated()))
+                ++it;
+        }
+
+        const_iterator(SetIt I, SetIt E) : it(I), end(E) { _findNextReal(); }
+
+      public:
+        const_iterator &operator++() {
+            ++it;
+            _findNextReal();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        LLVMPointer operator*() const {
+            assert(it != end && "Dereferenced end() iterator");
+            auto ptr = *it;
+            return {ptr.target->getUserData<llvm::Value>(), ptr.offset};
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return it == rhs.it;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class DGLLVMPointsToView;
+    };
+
+    DGLLVMPointsToView(const PointsToSetT &S) : PTSet(&S) {}
+
+    ///
+    // NOTE: this may not be O(1) operation
+    bool hasUnknown() const { return PTSet->hasUnknown(); }
+    bool hasNull() const { return PTSet->hasNull(); }
+    bool hasNullWithOffset() const { return PTSet->hasNullWithOffset(); }
+    bool hasInvalidated() const { return PTSet->hasInvalidated(); }
+    bool empty() const { return PTSet->empty(); }
+    size_t size() const { return PTSet->size(); }
+
+    bool isSingleton() const { return PTSet->size() == 1; }
+    bool isKnownSingleton() const {
+        return isSingleton() && !hasUnknown() && !hasNull() &&
+               !hasInvalidated();
+    }
+
+    // matches {unknown}
+    bool isUnknownSingleton() const { return isSingleton() && hasUnknown(); }
+
+    LLVMPointer getKnownSingleton() const {
+        assert(isKnownSingleton());
+        auto ptr = *PTSet->begin();
+        return {ptr.target->getUserData<llvm::Value>(), ptr.offset};
+    }
+
+    const PointsToSetT &getPointsToSet() const { return *PTSet; }
+
+    const_iterator begin() const { return {PTSet->begin(), PTSet->end()}; }
+    const_iterator end() const { return {PTSet->end(), PTSet->end()}; }
+};
+
 } // namespace dg
 
 #endif // LLVM_DG_POINTS_TO_SET_H_
@@ -10,6 +10,7 @@
 
 #include "dg/PointerAnalysis/Pointer.h"
 #include "dg/PointerAnalysis/PointerAnalysis.h"
+#include "dg/PointerAnalysis/PointerAnalysisDemand.h"
 #include "dg/PointerAnalysis/PointerAnalysisFI.h"
 #include "dg/PointerAnalysis/PointerAnalysisFS.h"
 #include "dg/PointerAnalysis/PointerAnalysisFSInv.h"
@@ -27,6 +28,9 @@ using pta::Pointer;
 using pta::PointerGraph;
 using pta::PSNode;
 
+// the result of an alias query
+enum class AliasResult { NoAlias, MayAlias, MustAlias };
+
 ///
 // Interface for LLVM pointer analysis
 class LLVMPointerAnalysis {
@@ -76,8 +80,37 @@ class LLVMPointerAnalysis {
     std::pair<bool, LLVMMemoryRegionSet>
     getAccessedMemory(const llvm::Instruction *I);
 
+    ///
+    // May the 'len1' bytes of memory pointed by 'v1' overlap with
+    // the 'len2' bytes of memory pointed by 'v2'? Length 0
+    // or Offset::UNKNOWN means that the length is not known.
+    // MustAlias is returned only if the pointers point to the same
+    // address of a memory that represents a single object.
+    virtual AliasResult alias(const llvm::Value *v1, Offset len1,
+                              const llvm::Value *v2, Offset len2);
+
+    AliasResult alias(const llvm::Value *v1, const llvm::Value *v2) {
+        return alias(v1, Offset::UNKNOWN, v2, Offset::UNKNOWN);
+    }
+
+    bool mayAlias(const llvm::Value *v1, Offset len1, const llvm::Value *v2,
+                  Offset len2) {
+        return alias(v1, len1, v2, len2) != AliasResult::NoAlias;
+    }
+
     virtual bool run() = 0;
 
+    ///
+    // Compute (at least) the points-to sets of the given values.
+    // Analyses that can answer the queries on demand process only
+    // the part of the program that is relevant for the values,
+    // so the points-to sets of other values may be incomplete
+    // until run() is called. By default, this runs the whole analysis.
+    virtual bool runOnDemand(const std::vector<const llvm::Value *> &vals) {
+        (void) vals;
+        return run();
+    }
+
     virtual ~LLVMPointerAnalysis() = default;
 };
 
@@ -193,6 +226,39 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
         return _unknownPTSet;
     }
 
+    // direct-mapped cache of alias queries, indexed by the hash
+    // of the IDs of the nodes (and the lengths). It is not
+    // synchronized, see alias().
+    struct AliasCacheEntry {
+        unsigned id1{0};
+        unsigned id2{0};
+        Offset len1{0};
+        Offset len2{0};
+        AliasResult result{AliasResult::MayAlias};
+    };
+
+    static const size_t ALIAS_CACHE_SIZE = 1 << 12;
+    std::vector<AliasCacheEntry> _aliasCache;
+
+    // state of demand-driven queries (see runOnDemand())
+    std::unique_ptr<pta::DemandDrivenPointerAnalysis> _demand;
+    // has the whole analysis been run?
+    bool _solved{false};
+    // were the results loaded from LLVMPointerAnalysisOptions::loadResultsFrom?
+    bool _loadedResults{false};
+
+    // get the points-to set of the value or the set {unknown} if
+    // there is no or empty points-to set. The boolean is false
+    // in the latter case.
+    std::pair<bool, const PointsToSetT &>
+    getPointsToSetOrUnknown(const llvm::Value *val) const {
+        if (auto *node = getPointsToNode(val)) {
+            if (!node->pointsTo.empty())
+                return {true, node->pointsTo};
+        }
+        return {false, getUnknownPTSet()};
+    }
+
   public:
     DGLLVMPointerAnalysis(const llvm::Module *m,
                           const char *entry_func = "main",
@@ -234,16 +300,7 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
     // and hasNull() that reflect whether the points-to set of the
     // LLVM value contains unknown element of null.
     LLVMPointsToSet getLLVMPointsTo(const llvm::Value *val) override {
-        DGLLVMPointsToSet *pts;
-        if (auto *node = getPointsToNode(val)) {
-            if (node->pointsTo.empty()) {
-                pts = new DGLLVMPointsToSet(getUnknownPTSet());
-            } else {
-                pts = new DGLLVMPointsToSet(node->pointsTo);
-            }
-        } else {
-            pts = new DGLLVMPointsToSet(getUnknownPTSet());
-        }
+        auto *pts = new DGLLVMPointsToSet(getPointsToSetOrUnknown(val).second);
         return pts->toLLVMPointsToSet();
     }
 
@@ -254,20 +311,55 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
     // unknown element when the node does not exists)
     std::pair<bool, LLVMPointsToSet>
     getLLVMPointsToChecked(const llvm::Value *val) override {
-        DGLLVMPointsToSet *pts;
-        if (auto *node = getPointsToNode(val)) {
-            if (node->pointsTo.empty()) {
-                pts = new DGLLVMPointsToSet(getUnknownPTSet());
-                return {false, pts->toLLVMPointsToSet()};
-            }
-            pts = new DGLLVMPointsToSet(node->pointsTo);
-            return {true, pts->toLLVMPointsToSet()};
-        }
-        pts = new DGLLVMPointsToSet(getUnknownPTSet());
-        return {false, pts->toLLVMPointsToSet()};
+        auto res = getPointsToSetOrUnknown(val);
+        auto *pts = new DGLLVMPointsToSet(res.second);
+        return {res.first, pts->toLLVMPointsToSet()};
+    }
+
+    ///
+    // The same as getLLVMPointsTo, but returns a non-owning view
+    // of the points-to set. Creating and iterating the view does
+    // not allocate any memory. The view is invalidated by running
+    // the analysis again.
+    DGLLVMPointsToView getLLVMPointsToView(const llvm::Value *val) const {
+        return {getPointsToSetOrUnknown(val).second};
+    }
+
+    // See getLLVMPointsToChecked()
+    std::pair<bool, DGLLVMPointsToView>
+    getLLVMPointsToViewChecked(const llvm::Value *val) const {
+        auto res = getPointsToSetOrUnknown(val);
+        return {res.first, DGLLVMPointsToView(res.second)};
     }
 
-    const std::vector<std::unique_ptr<PSNode>> &getNodes() {
+    ///
+    // Get views of points-to sets for all the values in 'vals'.
+    // The views are stored into 'out' (in the same order as the values)
+    // whose previous content is discarded, so that the caller
+    // can reuse the buffer for many queries.
+    template <typename ValuesT>
+    void getLLVMPointsToViews(const ValuesT &vals,
+                              std::vector<DGLLVMPointsToView> &out) const {
+        out.clear();
+        out.reserve(vals.size());
+        for (const llvm::Value *val : vals)
+            out.emplace_back(getPointsToSetOrUnknown(val).second);
+    }
+
+    using LLVMPointerAnalysis::alias;
+
+    ///
+    // Alias query answered from the points-to sets of the nodes.
+    // The results are cached (keyed on the IDs of the nodes),
+    // the cache is cleared when the analysis is run again.
+    // NOTE: the queries are not thread-safe. Besides filling
+    // the cache, they build the nodes for constant expressions
+    // on the first query, so they must not run concurrently
+    // with each other or with the analysis.
+    AliasResult alias(const llvm::Value *v1, Offset len1,
+                      const llvm::Value *v2, Offset len2) override;
+
+    const PointerGraph::NodesT &getNodes() {
         return PS->getNodes();
     }
 
@@ -291,16 +383,16 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
             abort();
         }
 
-        /*
-        pta::PointerGraphOptimizer optimizer(PS);
-        optimizer.run();
+        if (options.mergeEquivalentPointers) {
+            // loads of equivalent pointers yield the same
+            // points-to sets only in the flow-insensitive analysis
+            pta::PSEquivalentPointersMerger merger(PS, options.isFI());
+            for (PSNode *nd : _builder->getOpenNodes())
+                merger.addOpenNode(nd);
 
-        if (optimizer.getNumOfRemovedNodes() > 0)
-            _builder->composeMapping(std::move(optimizer.getMapping()));
-
-        llvm::errs() << "PS optimization removed " <<
-        optimizer.getNumOfRemovedNodes() << " nodes\n";
-        */
+            if (merger.run() > 0)
+                _builder->composeMapping(std::move(merger.getMapping()));
+        }
     }
 
     void initialize() {
@@ -329,8 +421,59 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
         if (!PTA) {
             initialize();
         }
-        return PTA->run();
+        _aliasCache.clear();
+        _solved = true;
+
+        if (!options.loadResultsFrom.empty()) {
+            _loadedResults = loadResults(options.loadResultsFrom);
+            if (_loadedResults)
+                return true;
+            llvm::errs() << "[PTA] could not load results from '"
+                         << options.loadResultsFrom
+                         << "', running the analysis\n";
+        }
+
+        bool ret = PTA->run();
+        if (PTA->exceededBudget()) {
+            llvm::errs() << "[PTA] the analysis ran out of its time or memory "
+                            "budget, "
+                         << PTA->getDegradedNodesNum()
+                         << " nodes were set to point to unknown memory\n";
+        }
+
+        if (!options.saveResultsTo.empty() &&
+            !saveResults(options.saveResultsTo)) {
+            llvm::errs() << "[PTA] could not save results to '"
+                         << options.saveResultsTo << "'\n";
+        }
+
+        return ret;
     }
+
+    ///
+    // Demand-driven solving of the flow-insensitive analysis (see
+    // pta::DemandDrivenPointerAnalysis). Other analyses and queries
+    // that exceed LLVMPointerAnalysisOptions::maxDemandedNodes
+    // fall back to run(). The graph is built again for the fallback,
+    // so the nodes obtained before (getPointsToNode()) are not valid then.
+    bool runOnDemand(const std::vector<const llvm::Value *> &vals) override;
+
+    ///
+    // Store the points-to sets of LLVM values and the call graph into
+    // a binary file. Other tools may load the file instead of running
+    // the analysis again (see LLVMPointerAnalysisOptions::loadResultsFrom)
+    bool saveResults(const std::string &path) const;
+
+    // have the results been loaded from a file instead of solving?
+    bool hasLoadedResults() const { return _loadedResults; }
+
+  private:
+    // Fill the points-to sets from a file created by saveResults().
+    // Returns false if the file cannot be read or if it was created
+    // for a different module (the names of types and of local values
+    // do not matter) or with different options that change the results,
+    // the graph is not touched then.
+    bool loadResults(const std::string &path);
 };
 
 // an auxiliary function
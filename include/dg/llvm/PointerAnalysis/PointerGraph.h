@@ -203,6 +203,7 @@ class LLVMPointerGraphBuilder {
 
   public:
     const PointerGraph *getPS() const { return &PS; }
+    const llvm::Module *getModule() const { return M; }
 
     inline bool threads() const { return threads_; }
 
@@ -272,9 +273,13 @@ class LLVMPointerGraphBuilder {
         this->invalidate_nodes = value;
     }
 
-    void composeMapping(PointsToMapping<PSNode *> &&rhs) {
-        mapping.compose(std::move(rhs));
-    }
+    // compose the mapping of removed nodes to their replacements
+    // (created by an optimization of the graph) into our mappings
+    void composeMapping(PointsToMapping<PSNode *> &&rhs);
+
+    // get the nodes that may obtain new operands while the analysis
+    // runs (formal arguments of functions and variadic arguments)
+    std::vector<PSNode *> getOpenNodes() const;
 
     PointerSubgraph *getSubgraph(const llvm::Function * /*F*/);
 
@@ -0,0 +1,23 @@
+#ifndef DG_LLVM_SDG2BINARY_H_
+#define DG_LLVM_SDG2BINARY_H_
+
+#include <string>
+
+#include "dg/BinaryGraph.h"
+
+namespace dg {
+namespace llvmdg {
+
+class SystemDependenceGraph;
+
+///
+// Store the system dependence graph into a file in the binary
+// format (see dg/BinaryGraph.h). The control dependencies of blocks
+// are stored as edges from the terminator of the controlling block
+// to all nodes of the dependent block.
+bool writeBinaryGraph(SystemDependenceGraph &sdg, const std::string &path);
+
+} // namespace llvmdg
+} // namespace dg
+
+#endif // DG_LLVM_SDG2BINARY_H_
@@ -5,8 +5,11 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "llvm/IR/Instructions.h"
+#include "llvm/Support/raw_ostream.h"
 
 #if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR <= 4))
 #include "llvm/DebugInfo.h" //DIScope
@@ -15,6 +18,7 @@
 #endif
 
 #include "dg/SystemDependenceGraph/DGNodeCall.h"
+#include "dg/llvm/LLVMValueFormatter.h"
 #include "dg/llvm/SystemDependenceGraph/SystemDependenceGraph.h"
 
 namespace dg {
@@ -34,14 +38,13 @@ static std::ostream& operator<<(std::ostream& os, const analysis::Offset& off)
 */
 
 namespace {
-inline std::ostream &printLLVMVal(std::ostream &os, const llvm::Value *val) {
-    if (!val) {
-        os << "(null)";
-        return os;
-    }
+inline std::string getLLVMValDotLabel(const llvm::Value *val,
+                                      LLVMValueFormatter &formatter) {
+    if (!val)
+        return "(null)";
 
-    std::ostringstream ostr;
-    llvm::raw_os_ostream ro(ostr);
+    std::string str;
+    llvm::raw_string_ostream ro(str);
 
     if (llvm::isa<llvm::Function>(val)) {
         ro << "FUN " << val->getName();
@@ -55,15 +58,14 @@ inline std::ostream &printLLVMVal(std::ostream &os, const llvm::Value *val) {
         } else {
             ro << "<null>::";
         }
-        ro << *val;
+        formatter.print(ro, val);
     } else {
-        ro << *val;
+        formatter.print(ro, val);
     }
 
     ro.flush();
 
     // break the string if it is too long
-    std::string str = ostr.str();
     if (str.length() > 50) {
         str.resize(40);
     }
@@ -76,9 +78,7 @@ inline std::ostream &printLLVMVal(std::ostream &os, const llvm::Value *val) {
         pos += 2;
     }
 
-    os << str;
-
-    return os;
+    return str;
 }
 } // anonymous namespace
 
@@ -92,6 +92,16 @@ class SDG2Dot {
 
     // keep track of dumped nodes for checking that we dumped all
     mutable std::set<sdg::DGNode *> dumpedNodes;
+    // formatted values (parameters share the value with the call)
+    mutable LLVMValueFormatter formatter;
+    mutable std::unordered_map<const llvm::Value *, std::string> labels;
+
+    const std::string &getLabel(const llvm::Value *v) const {
+        auto it = labels.find(v);
+        if (it == labels.end())
+            it = labels.emplace(v, getLLVMValDotLabel(v, formatter)).first;
+        return it->second;
+    }
 
     void dumpNode(std::ostream &out, sdg::DGNode &nd,
                   const llvm::Value *v = nullptr,
@@ -103,9 +113,9 @@ class SDG2Dot {
             << nd.getID() << "] ";
         if (v) {
             // this node is associated to this value
-            printLLVMVal(out, v);
+            out << getLabel(v);
         } else {
-            printLLVMVal(out, _llvmsdg->getValue(&nd));
+            out << getLabel(_llvmsdg->getValue(&nd));
         }
         if (descr) {
             out << " " << descr;
@@ -194,7 +204,11 @@ class SDG2Dot {
     SDG2Dot(SystemDependenceGraph *sdg) : _llvmsdg(sdg) {}
 
     void dump(const std::string &file) const {
-        std::ofstream out(file);
+        // the dump consists of many small writes, use a big buffer
+        std::vector<char> buffer(1 << 20);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        out.open(file);
         std::set<sdg::DGNodeCall *> calls;
 
         out << "digraph SDG {\n";
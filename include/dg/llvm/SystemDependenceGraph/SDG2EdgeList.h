@@ -0,0 +1,158 @@
+#ifndef DG_LLVM_SDG2EDGELIST_H_
+#define DG_LLVM_SDG2EDGELIST_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dg/EdgeListWriter.h"
+#include "dg/SystemDependenceGraph/DGNodeCall.h"
+#include "dg/llvm/LLVMDG2EdgeList.h"
+#include "dg/llvm/SystemDependenceGraph/SystemDependenceGraph.h"
+
+namespace dg {
+namespace llvmdg {
+
+///
+// Dump the system dependence graph as a list of nodes
+// and edges (see debug::EdgeListWriter)
+class SDG2EdgeList {
+    SystemDependenceGraph *_llvmsdg;
+    debug::EdgeListWriter _writer;
+    LLVMValueFormatter _formatter;
+    std::unordered_map<const sdg::DGNode *, unsigned> _ids;
+
+    unsigned getID(const sdg::DGNode *n) {
+        auto &id = _ids[n];
+        if (id == 0)
+            id = _ids.size();
+        return id;
+    }
+
+    unsigned getID(sdg::DGElement *e) {
+        // edges of blocks go from/to the first node of the block
+        if (auto *B = sdg::DGBBlock::get(e))
+            return getID(B->front());
+        return getID(sdg::DGNode::get(e));
+    }
+
+    // call fun(node, value, description) for all parameters
+    template <typename Fun>
+    static void forEachParam(sdg::DGParameters &params, Fun fun) {
+        for (auto &param : params) {
+            fun(param.getInputArgument(), &param, "in");
+            fun(param.getOutputArgument(), &param, "out");
+        }
+        if (auto *noret = params.getNoReturn())
+            fun(*noret, nullptr, "noret");
+        if (auto *ret = params.getReturn())
+            fun(*ret, nullptr, "ret");
+    }
+
+    // call fun(node, value, description) for all nodes of the graph
+    template <typename Fun>
+    static void forEachNode(sdg::DependenceGraph *dg, Fun fun) {
+        auto &formals = dg->getParameters();
+        forEachParam(formals, fun);
+        for (auto *nd : dg->getNodes()) {
+            // the return nodes of the function are among its nodes too
+            if (nd == formals.getNoReturn() || nd == formals.getReturn())
+                continue;
+            fun(*nd, nullptr, nullptr);
+            if (auto *C = sdg::DGNodeCall::get(nd))
+                forEachParam(C->getParameters(), fun);
+        }
+    }
+
+    void dumpNode(sdg::DGNode &nd, const sdg::DGElement *elem,
+                  const char *descr, const std::string &fun) {
+        auto label = debug::getLLVMValueLabel(
+                _llvmsdg->getValue(elem ? elem : &nd), _formatter);
+        if (descr)
+            label = std::string(descr) + " " + label;
+        _writer.node(getID(&nd), fun, label);
+    }
+
+    void dumpNodeEdges(sdg::DGNode &nd) {
+        auto id = getID(&nd);
+        for (auto *use : nd.uses())
+            _writer.edge(id, getID(use), "use");
+        for (auto *def : nd.memdep())
+            _writer.edge(getID(def), id, "dd");
+        for (auto *ctrl : nd.controls())
+            _writer.edge(id, getID(ctrl), "cd");
+
+        if (auto *C = sdg::DGNodeCall::get(&nd)) {
+            // the call site defines the output parameters
+            auto &params = C->getParameters();
+            for (auto &param : params)
+                _writer.edge(id, getID(&param.getOutputArgument()), "param");
+            if (auto *noret = params.getNoReturn())
+                _writer.edge(id, getID(noret), "param");
+            if (auto *ret = params.getReturn())
+                _writer.edge(id, getID(ret), "param");
+            for (auto *dg : C->getCallees())
+                _writer.edge(id, getID(dg->getFirstNode()), "call");
+        }
+    }
+
+    void dumpGraphNodes(sdg::DependenceGraph *dg) {
+        const auto &name = dg->getName();
+        forEachNode(dg, [&](sdg::DGNode &nd, const sdg::DGElement *elem,
+                            const char *descr) {
+            dumpNode(nd, elem, descr, name);
+        });
+    }
+
+    void dumpGraphEdges(sdg::DependenceGraph *dg) {
+        forEachNode(dg,
+                    [&](sdg::DGNode &nd, const sdg::DGElement *, const char *) {
+                        dumpNodeEdges(nd);
+                    });
+        for (auto *blk : dg->getBBlocks()) {
+            if (blk->getNodes().empty())
+                continue;
+            for (auto *ctrl : blk->controls())
+                _writer.edge(getID(blk->back()), getID(ctrl), "cd");
+        }
+    }
+
+  public:
+    SDG2EdgeList(SystemDependenceGraph *sdg, debug::EdgeListFormat format)
+            : _llvmsdg(sdg), _writer(format) {}
+
+    const char *getSuffix() const { return _writer.getSuffix(); }
+
+    bool dump(const std::string &file) {
+        if (!_writer.open(file.c_str()))
+            return false;
+
+        // all the nodes must go before the edges
+        for (auto *dg : _llvmsdg->getSDG())
+            dumpGraphNodes(dg);
+        for (auto *dg : _llvmsdg->getSDG())
+            dumpGraphEdges(dg);
+
+        _writer.close();
+        return true;
+    }
+
+    // dump every function into its own file 'prefix.function.(json|csv)'
+    bool dumpSharded(const std::string &prefix) {
+        for (auto *dg : _llvmsdg->getSDG()) {
+            if (!_writer.open(
+                        (prefix + "." + dg->getName() + getSuffix()).c_str()))
+                return false;
+            dumpGraphNodes(dg);
+            dumpGraphEdges(dg);
+        }
+
+        _writer.close();
+        return true;
+    }
+};
+
+} // namespace llvmdg
+} // namespace dg
+
+#endif // DG_LLVM_SDG2EDGELIST_H_
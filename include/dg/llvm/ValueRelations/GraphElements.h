@@ -203,6 +203,9 @@ class VRCodeGraph {
 
     void hasCategorizedEdges();
 
+    // number of locations, all VRLocation::id are smaller than this number
+    size_t size() const { return locations.size(); }
+
     /* ************ function iterator stuff ************ */
 
   private:
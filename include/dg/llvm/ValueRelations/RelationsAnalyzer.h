@@ -8,6 +8,9 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Value.h>
 
+#include <chrono>
+#include <map>
+#include <set>
 #include <vector>
 
 #include "GraphElements.h"
@@ -21,6 +24,36 @@
 namespace dg {
 namespace vr {
 
+struct RelationsAnalyzerOptions {
+    // maximal number of passes over a single function
+    unsigned maxPass{20};
+
+    // maximal number of times relations at a loop header may change
+    // before they get widened, 0 means unlimited; widening drops
+    // the relations of all values that changed during these iterations
+    unsigned maxLoopIterations{0};
+
+    // time budget for the whole analysis in milliseconds, 0 means unlimited;
+    // functions that were not analyzed in time keep empty relations
+    unsigned timeout{0};
+
+    // maximal number of buckets kept at a single location, 0 means unlimited;
+    // locations exceeding the limit forget all their relations
+    size_t maxBuckets{0};
+};
+
+struct RelationsAnalyzerStats {
+    // the highest number of passes made over a function
+    unsigned maxExecutedPass{0};
+    // loop headers that exceeded maxLoopIterations and were widened
+    unsigned widenedLocations{0};
+    // locations that exceeded maxBuckets
+    unsigned overBudgetLocations{0};
+    // functions that did not reach a fixpoint
+    unsigned unfinishedFunctions{0};
+    bool timedOut{false};
+};
+
 class RelationsAnalyzer {
     using Handle = ValueRelations::Handle;
     using HandlePtr = ValueRelations::HandlePtr;
@@ -41,6 +74,36 @@ class RelationsAnalyzer {
     // or possibly set of values defined at given location
     StructureAnalyzer &structure;
 
+    RelationsAnalyzerOptions options;
+    RelationsAnalyzerStats stats;
+
+    // ***************************** budget ****************************** //
+    using Clock = std::chrono::steady_clock;
+    // the number of equal values and of related buckets of each value
+    using Signature = std::map<V, std::pair<size_t, size_t>>;
+
+    struct LoopBudget {
+        unsigned changes = 0;
+        bool widened = false;
+        // the relations after the last change
+        Signature last;
+        // values whose relations changed between two iterations
+        std::set<V> unstable;
+    };
+
+    std::map<const VRLocation *, LoopBudget> loopBudgets;
+    // locations that exceeded maxBuckets, they do not keep any relations
+    std::set<const VRLocation *> forgotten;
+    Clock::time_point startTime;
+
+    static bool isLoopHeader(const VRLocation &location);
+    static Signature getSignature(const ValueRelations &relations);
+    static void addUnstable(const Signature &last, const Signature &current,
+                            std::set<V> &unstable, bool missing);
+    static bool widen(ValueRelations &relations, LoopBudget &budget);
+    bool checkBudget(VRLocation &location);
+    bool isOutOfTime() const;
+
     // ********************** points to invalidation ********************** //
     static bool isIgnorableIntrinsic(llvm::Intrinsic::ID id);
     bool isSafe(I inst) const;
@@ -177,8 +240,17 @@ class RelationsAnalyzer {
                       StructureAnalyzer &sa)
             : module(m), codeGraph(g), structure(sa) {}
 
+    RelationsAnalyzer(const llvm::Module &m, const VRCodeGraph &g,
+                      StructureAnalyzer &sa,
+                      const RelationsAnalyzerOptions &opts)
+            : module(m), codeGraph(g), structure(sa), options(opts) {}
+
+    // returns the highest number of passes made over a function
+    unsigned analyze();
     unsigned analyze(unsigned maxPass);
 
+    const RelationsAnalyzerStats &getStatistics() const { return stats; }
+
     static std::vector<V> getFroms(const ValueRelations &rels, V val);
     static HandlePtr getHandleFromFroms(const ValueRelations &rels,
                                         const std::vector<V> &froms);
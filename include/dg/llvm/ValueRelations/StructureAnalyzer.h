@@ -8,6 +8,7 @@
 #include <llvm/IR/Value.h>
 
 #include <algorithm>
+#include <unordered_map>
 
 #include "GraphElements.h"
 #include "StructureElements.h"
@@ -26,8 +27,9 @@ class StructureAnalyzer {
     std::map<const VRLocation *, std::vector<const llvm::Instruction *>>
             inloopValues;
 
-    // holds vector of values, which are defined at given location
-    std::map<VRLocation *, std::set<const llvm::Value *>> defined;
+    // holds set of values, which are defined at given location,
+    // indexed by VRLocation::id
+    std::vector<std::set<const llvm::Value *>> defined;
 
     const std::vector<unsigned> collected = {llvm::Instruction::Add,
                                              llvm::Instruction::Sub,
@@ -35,6 +37,13 @@ class StructureAnalyzer {
     std::map<unsigned, std::set<const llvm::Instruction *>> instructionSets;
 
     std::vector<AllocatedArea> allocatedAreas;
+    // index of allocated area in allocatedAreas by its pointer
+    std::unordered_map<const llvm::Value *, unsigned> areaIndices;
+    // areas allocated on heap
+    ValidAreas heapAreas;
+
+    // areas valid at given location, indexed by VRLocation::id
+    std::vector<ValidAreas> validAreasByLocation;
 
     std::map<const llvm::Function *, std::vector<CallRelation>>
             callRelationsMap;
@@ -58,42 +67,39 @@ class StructureAnalyzer {
 
     void collectAllocatedAreas();
 
-    void setValidAreasFromNoPredecessors(std::vector<bool> &validAreas) const;
+    void setValidAreasFromNoPredecessors(ValidAreas &validAreas) const;
 
     std::pair<unsigned, const AllocatedArea *>
     getEqualArea(const ValueRelations &graph, const llvm::Value *ptr) const;
 
-    void invalidateHeapAllocatedAreas(std::vector<bool> &validAreas) const;
+    void invalidateHeapAllocatedAreas(ValidAreas &validAreas) const;
 
     void setValidAreasByInstruction(VRLocation &location,
-                                    std::vector<bool> &validAreas,
+                                    ValidAreas &validAreas,
                                     VRInstruction *vrinst) const;
 
-    void setValidArea(std::vector<bool> &validAreas, const AllocatedArea *area,
+    void setValidArea(ValidAreas &validAreas, const AllocatedArea *area,
                       unsigned index, bool validateThis) const;
 
     // if heap allocation call was just checked as successful, mark memory valid
     void setValidAreasByAssumeBool(VRLocation &location,
-                                   std::vector<bool> &validAreas,
+                                   ValidAreas &validAreas,
                                    VRAssumeBool *assume) const;
 
-    void
-    setValidAreasFromSinglePredecessor(VRLocation &location,
-                                       std::vector<bool> &validAreas) const;
-
-    static bool trueInAll(const std::vector<std::vector<bool>> &validInPreds,
-                          unsigned index);
+    void setValidAreasFromSinglePredecessor(VRLocation &location,
+                                            ValidAreas &validAreas) const;
 
-    // in returned vector, false signifies that corresponding area is
+    // in returned set, unset bit signifies that corresponding area is
     // invalidated by some of the passed instructions
-    std::vector<bool> getInvalidatedAreas(
+    ValidAreas getInvalidatedAreas(
             const std::vector<const llvm::Instruction *> &instructions) const;
 
-    void
-    setValidAreasFromMultiplePredecessors(VRLocation &location,
-                                          std::vector<bool> &validAreas) const;
+    void setValidAreasFromMultiplePredecessors(VRLocation &location,
+                                               ValidAreas &validAreas) const;
+
+    void computeValidAreas(const llvm::Function &function);
 
-    void computeValidAreas() const;
+    void computeValidAreas();
 
     void initializeCallRelations();
 
@@ -128,6 +134,13 @@ class StructureAnalyzer {
 
     unsigned getNumberOfAllocatedAreas() const { return allocatedAreas.size(); }
 
+    // areas that are surely valid at given location, computed by
+    // analyzeAfterRelationsAnalysis
+    const ValidAreas &getValidAreas(const VRLocation &location) const {
+        assert(location.id < validAreasByLocation.size());
+        return validAreasByLocation[location.id];
+    }
+
     const std::vector<CallRelation> &
     getCallRelationsFor(const llvm::Instruction *inst) const;
 
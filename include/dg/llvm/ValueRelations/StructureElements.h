@@ -3,6 +3,9 @@
 
 #include <llvm/IR/Value.h>
 
+#include <cstdint>
+#include <vector>
+
 #include "GraphElements.h"
 
 namespace dg {
@@ -43,6 +46,65 @@ class AllocatedArea {
 #endif
 };
 
+// dense set of indices of allocated areas, one bit per area
+class ValidAreas {
+    using Word = uint64_t;
+    static const size_t BITS_IN_WORD = sizeof(Word) * 8;
+
+    std::vector<Word> words;
+    size_t _size = 0;
+
+    static Word mask(size_t i) { return Word{1} << (i % BITS_IN_WORD); }
+
+  public:
+    ValidAreas() = default;
+    ValidAreas(size_t size, bool value)
+            : words((size + BITS_IN_WORD - 1) / BITS_IN_WORD,
+                    value ? ~Word{0} : Word{0}),
+              _size(size) {
+        // keep the bits past the end unset so that sets can be compared
+        if (value && size % BITS_IN_WORD != 0)
+            words.back() &= mask(size) - 1;
+    }
+
+    size_t size() const { return _size; }
+    // empty set of areas signifies that the location was not computed yet
+    bool empty() const { return _size == 0; }
+
+    bool get(size_t i) const {
+        assert(i < _size);
+        return words[i / BITS_IN_WORD] & mask(i);
+    }
+    bool operator[](size_t i) const { return get(i); }
+
+    void set(size_t i) {
+        assert(i < _size);
+        words[i / BITS_IN_WORD] |= mask(i);
+    }
+    void reset(size_t i) {
+        assert(i < _size);
+        words[i / BITS_IN_WORD] &= ~mask(i);
+    }
+
+    // keep only areas valid also in rhs
+    void intersect(const ValidAreas &rhs) {
+        assert(_size == rhs._size);
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] &= rhs.words[i];
+    }
+    // invalidate all areas that are set in rhs
+    void subtract(const ValidAreas &rhs) {
+        assert(_size == rhs._size);
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] &= ~rhs.words[i];
+    }
+
+    bool operator==(const ValidAreas &rhs) const {
+        return _size == rhs._size && words == rhs.words;
+    }
+    bool operator!=(const ValidAreas &rhs) const { return !(*this == rhs); }
+};
+
 struct CallRelation {
     std::vector<std::pair<const llvm::Argument *, const llvm::Value *>>
             equalPairs;
@@ -39,7 +39,6 @@ struct ValueRelations {
 
     ValToBucket valToBucket;
     BucketToVals bucketToVals;
-    std::vector<bool> validAreas;
 
     bool changed = false;
 
@@ -468,9 +467,6 @@ struct ValueRelations {
         return mH->getRelated(Relations::PT);
     }
 
-    std::vector<bool> &getValidAreas() { return validAreas; }
-    const std::vector<bool> &getValidAreas() const { return validAreas; }
-
     // ************************** placeholder ***************************** //
     Handle newBorderBucket(size_t id) {
         Handle h = graph.getBorderBucket(id);
@@ -502,6 +498,8 @@ struct ValueRelations {
         return old;
     }
     bool holdsAnyRelations() const;
+    // forget all values and relations, only the (empty) border buckets stay
+    void clear();
 
     HandlePtr getBorderH(size_t id) const;
     size_t getBorderId(Handle h) const;
@@ -0,0 +1,55 @@
+#ifndef DG_UTIL_PARALLEL_H_
+#define DG_UTIL_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace dg {
+
+///
+// The number of threads that should run 'jobs' independent jobs
+// when the user asked for 'workers' threads (0 means one thread
+// per CPU). There is no point in having more threads than jobs.
+inline unsigned getWorkersNum(unsigned workers, size_t jobs) {
+    if (workers == 0)
+        workers = std::thread::hardware_concurrency();
+    return static_cast<unsigned>(
+            std::max<size_t>(1, std::min<size_t>(workers, jobs)));
+}
+
+///
+// Run 'worker(id)' in 'workers' threads with ids 0 to workers - 1
+// and wait until all of them finish. The calling thread is
+// the worker 0, so no thread is started for a single worker.
+template <typename Fun>
+void runWorkers(unsigned workers, Fun worker) {
+    std::vector<std::thread> threads;
+    threads.reserve(workers > 0 ? workers - 1 : 0);
+    for (unsigned id = 1; id < workers; ++id)
+        threads.emplace_back(worker, id);
+    worker(0U);
+    for (auto &thr : threads)
+        thr.join();
+}
+
+///
+// Call 'fun(i, id)' for every i in [0, n), where 'id' is the id of
+// the worker that runs the call (see runWorkers()). The calls are
+// distributed between getWorkersNum(workers, n) threads, so 'fun'
+// must be thread-safe unless 'workers' is 1.
+template <typename Fun>
+void parallelFor(size_t n, unsigned workers, Fun fun) {
+    std::atomic<size_t> next{0};
+    runWorkers(getWorkersNum(workers, n), [&fun, &next, n](unsigned id) {
+        size_t i;
+        while ((i = next++) < n)
+            fun(i, id);
+    });
+}
+
+} // namespace dg
+
+#endif // DG_UTIL_PARALLEL_H_
@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dg/BinaryGraph.h"
+
+namespace dg {
+namespace binary {
+
+namespace {
+
+const char MAGIC[8] = {'D', 'G', 'G', 'R', 'A', 'P', 'H', '\0'};
+const unsigned NUM_EDGE_KINDS = static_cast<unsigned>(EdgeKind::NUM_KINDS);
+
+uint64_t align(uint64_t off) { return (off + 7) & ~static_cast<uint64_t>(7); }
+
+void pad(std::ostream &out, uint64_t &off) {
+    static const char zeros[8] = {0};
+    uint64_t aligned = align(off);
+    out.write(zeros, aligned - off);
+    off = aligned;
+}
+
+template <typename T>
+void writeArray(std::ostream &out, uint64_t &off, const T *data, size_t num) {
+    out.write(reinterpret_cast<const char *>(data), sizeof(T) * num);
+    off += sizeof(T) * num;
+}
+
+// edges (sorted and without duplicates) in the CSR format,
+// the index followed by the targets
+std::vector<uint32_t> toCSR(std::vector<std::pair<uint32_t, uint32_t>> &edges,
+                            uint32_t numNodes) {
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::vector<uint32_t> csr(numNodes + 1 + edges.size(), 0);
+    for (const auto &edge : edges)
+        ++csr[edge.first + 1];
+    for (uint32_t i = 0; i < numNodes; ++i)
+        csr[i + 1] += csr[i];
+    uint32_t *targets = csr.data() + numNodes + 1;
+    for (size_t i = 0; i < edges.size(); ++i)
+        targets[i] = edges[i].second;
+    return csr;
+}
+
+} // anonymous namespace
+
+uint32_t BinaryGraphWriter::addFunction(uint32_t name) {
+    _functions.push_back({name, static_cast<uint32_t>(_nodes.size()), 0, NONE});
+    return _functions.size() - 1;
+}
+
+uint32_t BinaryGraphWriter::addNode(NodeRecord node) {
+    if (_functions.empty()) {
+        node.function = NONE;
+    } else {
+        node.function = _functions.size() - 1;
+        ++_functions.back().numNodes;
+    }
+    _nodes.push_back(node);
+    return _nodes.size() - 1;
+}
+
+bool BinaryGraphWriter::write(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open())
+        return false;
+
+    const auto numNodes = static_cast<uint32_t>(_nodes.size());
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.numNames = _names.size();
+    header.numFunctions = _functions.size();
+    header.numNodes = numNodes;
+
+    std::vector<uint32_t> nameOffsets;
+    nameOffsets.reserve(_names.size() + 1);
+    uint32_t namesSize = 0;
+    for (const auto &name : _names) {
+        nameOffsets.push_back(namesSize);
+        namesSize += name.size() + 1;
+    }
+    nameOffsets.push_back(namesSize);
+
+    // the edges in both directions
+    std::vector<uint32_t> csrs[NUM_EDGE_KINDS][2];
+    for (unsigned k = 0; k < NUM_EDGE_KINDS; ++k) {
+        auto edges = _edges[k];
+        csrs[k][0] = toCSR(edges, numNodes);
+        for (auto &edge : edges)
+            std::swap(edge.first, edge.second);
+        csrs[k][1] = toCSR(edges, numNodes);
+    }
+
+    // compute the layout
+    uint64_t off = align(sizeof(Header));
+    header.names = off;
+    off = align(off + sizeof(uint32_t) * nameOffsets.size() + namesSize);
+    header.functions = off;
+    off = align(off + sizeof(FunctionRecord) * _functions.size());
+    header.nodes = off;
+    off = align(off + sizeof(NodeRecord) * _nodes.size());
+    for (unsigned k = 0; k < NUM_EDGE_KINDS; ++k) {
+        for (unsigned dir = 0; dir < 2; ++dir) {
+            header.edges[k][dir] = off;
+            off = align(off + sizeof(uint32_t) * csrs[k][dir].size());
+        }
+    }
+
+    off = 0;
+    writeArray(out, off, &header, 1);
+    pad(out, off);
+    writeArray(out, off, nameOffsets.data(), nameOffsets.size());
+    for (const auto &name : _names)
+        writeArray(out, off, name.c_str(), name.size() + 1);
+    pad(out, off);
+    writeArray(out, off, _functions.data(), _functions.size());
+    pad(out, off);
+    writeArray(out, off, _nodes.data(), _nodes.size());
+    pad(out, off);
+    for (unsigned k = 0; k < NUM_EDGE_KINDS; ++k) {
+        for (unsigned dir = 0; dir < 2; ++dir) {
+            writeArray(out, off, csrs[k][dir].data(), csrs[k][dir].size());
+            pad(out, off);
+        }
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool BinaryGraph::open(const std::string &path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+
+    _size = st.st_size;
+    _data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (_data == MAP_FAILED) {
+        _data = nullptr;
+        return false;
+    }
+
+    _header = static_cast<const Header *>(_data);
+    if (!check()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void BinaryGraph::close() {
+    if (_data)
+        munmap(_data, _size);
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+}
+
+// check that the file is a graph and that all the
+// indices are in bounds, so that we do not need
+// to check anything when traversing the graph
+bool BinaryGraph::check() {
+    const auto &H = *_header;
+    if (std::memcmp(H.magic, MAGIC, sizeof(MAGIC)) != 0 || H.version != VERSION)
+        return false;
+
+    const char *base = static_cast<const char *>(_data);
+    // is there the array of 'num' elements of size 'size' at 'off'?
+    auto fits = [this](uint64_t off, uint64_t num, uint64_t size) {
+        return off <= _size && num <= (_size - off) / size;
+    };
+    // the same for the beginning of a section
+    auto section = [&fits](uint64_t off, uint64_t num, uint64_t size) {
+        return off % 8 == 0 && fits(off, num, size);
+    };
+
+    if (!section(H.names, uint64_t(H.numNames) + 1, sizeof(uint32_t)))
+        return false;
+    _nameOffsets = reinterpret_cast<const uint32_t *>(base + H.names);
+    _names = reinterpret_cast<const char *>(_nameOffsets + H.numNames + 1);
+    uint64_t namesSize = _nameOffsets[H.numNames];
+    if (!fits(_names - base, namesSize, 1) ||
+        (namesSize > 0 && _names[namesSize - 1] != '\0'))
+        return false;
+    for (uint32_t i = 0; i < H.numNames; ++i) {
+        if (_nameOffsets[i] > _nameOffsets[i + 1])
+            return false;
+    }
+
+    if (!section(H.functions, H.numFunctions, sizeof(FunctionRecord)) ||
+        !section(H.nodes, H.numNodes, sizeof(NodeRecord)))
+        return false;
+    _functions = reinterpret_cast<const FunctionRecord *>(base + H.functions);
+    _nodes = reinterpret_cast<const NodeRecord *>(base + H.nodes);
+
+    for (uint32_t i = 0; i < H.numFunctions; ++i) {
+        const auto &F = _functions[i];
+        if ((F.name != NONE && F.name >= H.numNames) ||
+            F.firstNode > H.numNodes || F.numNodes > H.numNodes - F.firstNode ||
+            (F.entry != NONE && F.entry >= H.numNodes))
+            return false;
+    }
+    for (uint32_t i = 0; i < H.numNodes; ++i) {
+        const auto &N = _nodes[i];
+        if ((N.function != NONE && N.function >= H.numFunctions) ||
+            (N.name != NONE && N.name >= H.numNames) ||
+            (N.owner != NONE && N.owner >= H.numNodes))
+            return false;
+    }
+
+    for (unsigned k = 0; k < NUM_EDGE_KINDS; ++k) {
+        for (unsigned dir = 0; dir < 2; ++dir) {
+            uint64_t off = H.edges[k][dir];
+            if (!section(off, uint64_t(H.numNodes) + 1, sizeof(uint32_t)))
+                return false;
+            const auto *index = reinterpret_cast<const uint32_t *>(base + off);
+            const auto *targets = index + H.numNodes + 1;
+            if (index[0] != 0 ||
+                !fits(off + sizeof(uint32_t) * (uint64_t(H.numNodes) + 1),
+                      index[H.numNodes], sizeof(uint32_t)))
+                return false;
+            for (uint32_t i = 0; i < H.numNodes; ++i) {
+                if (index[i] > index[i + 1])
+                    return false;
+            }
+            for (uint32_t i = 0; i < index[H.numNodes]; ++i) {
+                if (targets[i] >= H.numNodes)
+                    return false;
+            }
+            _edges[k][dir] = index;
+        }
+    }
+
+    return true;
+}
+
+uint32_t BinaryGraph::findFunction(const std::string &name) const {
+    for (uint32_t i = 0; i < getNumFunctions(); ++i) {
+        const auto &F = _functions[i];
+        if (F.name != NONE && name == getName(F.name))
+            return i;
+    }
+    return NONE;
+}
+
+} // namespace binary
+} // namespace dg
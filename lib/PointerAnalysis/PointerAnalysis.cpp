@@ -1,3 +1,5 @@
+#include <sys/resource.h>
+
 #include "dg/PointerAnalysis/PointerAnalysis.h"
 #include "dg/PointerAnalysis/Pointer.h"
 #include "dg/PointerAnalysis/PointsToSet.h"
@@ -251,7 +253,8 @@ bool PointerAnalysis::processMemcpy(std::vector<MemoryObject *> &srcObjects,
 
                         Offset newOff = *src.first - *srcOffset + *destOffset;
                         if (newOff >= destO->node->getSize() ||
-                            newOff >= options.fieldSensitivity) {
+                            newOff >= options.fieldSensitivity ||
+                            boundOffset(destO->node, newOff).isUnknown()) {
                             changed |= destO->addPointsTo(Offset::UNKNOWN,
                                                           src.second);
                         } else {
@@ -269,6 +272,29 @@ bool PointerAnalysis::processMemcpy(std::vector<MemoryObject *> &srcObjects,
     return changed;
 }
 
+Offset PointerAnalysis::boundOffset(PSNode *target, Offset off) {
+    if (options.maxObjectOffsets == 0 || off.isUnknown())
+        return off;
+
+    auto &info = _objectOffsets[target];
+    if (info.collapsed)
+        return Offset::UNKNOWN;
+
+    info.offsets.insert(off);
+    if (info.offsets.size() <= options.maxObjectOffsets)
+        return off;
+
+    // the pointers with concrete offsets that we created so far
+    // may stay, loads and stores via them take into account
+    // also the Offset::UNKNOWN that we use from now on
+    DBG(pta, "Collapsing object " << target->getID() << " with "
+                                  << info.offsets.size() << " offsets");
+    info.collapsed = true;
+    info.offsets.clear();
+    _collapsedObjects.push_back(target);
+    return Offset::UNKNOWN;
+}
+
 bool PointerAnalysis::processGep(PSNode *node) {
     bool changed = false;
 
@@ -288,7 +314,8 @@ bool PointerAnalysis::processGep(PSNode *node) {
         // to the begining of the memory - therefore make 0 exception
         if ((new_offset == 0 || new_offset < ptr.target->getSize()) &&
             new_offset < *options.fieldSensitivity)
-            changed |= node->addPointsTo(ptr.target, new_offset);
+            changed |= node->addPointsTo(
+                    ptr.target, boundOffset(ptr.target, new_offset));
         else
             changed |= node->addPointsTo(ptr.target, Offset::UNKNOWN);
     }
@@ -485,9 +512,94 @@ static void setToEmpty(std::vector<PSNode *> &nodes) {
     }
 }
 
+static size_t getMaxRSSInMB() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    // ru_maxrss is in kilobytes on Linux
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;
+}
+
+bool PointerAnalysis::isOverBudget() const {
+    if (options.timeout > 0 &&
+        Clock::now() - _startTime >= std::chrono::milliseconds(options.timeout))
+        return true;
+
+    return options.maxMemory > 0 && getMaxRSSInMB() >= options.maxMemory;
+}
+
+// A pending call via a function pointer may call any function whose
+// address is taken (its operand may point to unknown memory in the end),
+// so connect it to all such functions to keep the call graph sound.
+// The nodes created by building the called functions are added
+// to 'nodes', they have not been processed either.
+void PointerAnalysis::resolvePendingCalls(std::vector<PSNode *> &nodes) {
+    const auto &allNodes = PG->getNodes();
+    size_t scanned = allNodes.size();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        // new subgraphs may take the address of other functions
+        std::vector<PSNode *> functions;
+        for (const auto &nd : allNodes) {
+            if (nd && funHasAddressTaken(nd.get()))
+                functions.push_back(nd.get());
+        }
+
+        // 'nodes' grow in the loop
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            PSNode *call = nodes[i];
+            if (call->getType() != PSNodeType::CALL_FUNCPTR)
+                continue;
+
+            bool connected = false;
+            for (PSNode *fun : functions) {
+                if (call->addPointsTo(fun, 0)) {
+                    functionPointerCall(call, fun);
+                    connected = true;
+                }
+            }
+            // the return site gets new operands
+            if (connected && call->getPairedNode())
+                nodes.push_back(call->getPairedNode());
+            changed |= connected;
+        }
+
+        for (; scanned < allNodes.size(); ++scanned) {
+            if (allNodes[scanned])
+                nodes.push_back(allNodes[scanned].get());
+        }
+    }
+}
+
+// Set the nodes whose points-to sets are not final to point to unknown
+// memory. The nodes that could get new information from these nodes
+// are reachable from them, so they are in the set too.
+void PointerAnalysis::degradeToUnknown(std::vector<PSNode *> &nodes) {
+    resolvePendingCalls(nodes);
+
+    for (auto *n : nodes) {
+        switch (n->getType()) {
+        case PSNodeType::ALLOC:
+        case PSNodeType::CONSTANT:
+        case PSNodeType::FUNCTION:
+        case PSNodeType::NULL_ADDR:
+        case PSNodeType::UNKNOWN_MEM:
+        case PSNodeType::INVALIDATED:
+            continue;
+        default:
+            if (n->addPointsTo(UnknownPointer))
+                ++_degradedNodes;
+        }
+    }
+}
+
 bool PointerAnalysis::run() {
     DBG_SECTION_BEGIN(pta, "Running pointer analysis");
 
+    _startTime = Clock::now();
+    _degradedNodes = 0;
+
     preprocess();
 
     // check that the current state of pointer analysis makes sense
@@ -520,6 +632,14 @@ bool PointerAnalysis::run() {
             to_process.clear();
             break;
         }
+        if (n > 0 && isOverBudget()) {
+            DBG(pta, "Out of budget after " << n << " iterations, "
+                                            << to_process.size()
+                                            << " nodes are pending");
+            degradeToUnknown(to_process);
+            to_process.clear();
+            break;
+        }
 #if DEBUG_ENABLED
 #define DUMP_NTH_ITER 100
         if (n % DUMP_NTH_ITER == 0) {
@@ -0,0 +1,194 @@
+#include <unordered_set>
+
+#include "dg/PointerAnalysis/PointerAnalysisDemand.h"
+
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace pta {
+
+static bool writesMemory(const PSNode *nd) {
+    return nd->getType() == PSNodeType::STORE ||
+           nd->getType() == PSNodeType::MEMCPY;
+}
+
+static bool readsMemory(const PSNode *nd) {
+    return nd->getType() == PSNodeType::LOAD ||
+           nd->getType() == PSNodeType::MEMCPY;
+}
+
+static PSNode *getWrittenPointer(PSNode *nd) {
+    if (auto *memcpy = PSNodeMemcpy::get(nd))
+        return memcpy->getDestination();
+    return nd->getOperand(1);
+}
+
+static PSNode *getReadPointer(PSNode *nd) {
+    if (auto *memcpy = PSNodeMemcpy::get(nd))
+        return memcpy->getSource();
+    return nd->getOperand(0);
+}
+
+// the node that represents the memory pointed by the pointer
+// (the same as in PointerAnalysisFI::getMemoryObjects)
+static PSNode *getMemoryNode(const Pointer &ptr) {
+    PSNode *n = ptr.target;
+    if (n->getType() == PSNodeType::CAST || n->getType() == PSNodeType::GEP)
+        return n->getOperand(0);
+    if (n->getType() == PSNodeType::CONSTANT)
+        return (*n->pointsTo.begin()).target;
+    return n;
+}
+
+void DemandDrivenPointerAnalysis::initialize() {
+    PTA.preprocess();
+
+    // globals are processed only once, the same as in the whole analysis
+    for (PSNode *g : PTA.getPG()->getGlobals())
+        PTA.processNode(g);
+
+    initialized = true;
+}
+
+void DemandDrivenPointerAnalysis::scanNewNodes(
+        std::vector<PSNode *> &worklist) {
+    const auto &nodes = PTA.getPG()->getNodes();
+    demanded.resize(nodes.size(), false);
+
+    for (; scannedNodes < nodes.size(); ++scannedNodes) {
+        PSNode *nd = nodes[scannedNodes].get();
+        if (!nd)
+            continue;
+
+        if (writesMemory(nd))
+            writers.push_back(nd);
+        // a call via a pointer may add operands to any function,
+        // so we must always know where it goes
+        else if (nd->getType() == PSNodeType::CALL_FUNCPTR)
+            worklist.push_back(nd);
+    }
+}
+
+bool DemandDrivenPointerAnalysis::demand(std::vector<PSNode *> &worklist) {
+    while (!worklist.empty()) {
+        PSNode *nd = worklist.back();
+        worklist.pop_back();
+
+        // special nodes have fixed points-to sets
+        if (nd->getID() <= PointerGraphReservedIDs::LAST_RESERVED_ID)
+            continue;
+        if (demanded[nd->getID()])
+            continue;
+
+        demanded[nd->getID()] = true;
+        relevant.push_back(nd);
+        if (maxNodes > 0 && relevant.size() > maxNodes)
+            return false;
+
+        if (readsMemory(nd))
+            readers.push_back(nd);
+
+        for (PSNode *op : nd->getOperands())
+            worklist.push_back(op);
+    }
+
+    return true;
+}
+
+void DemandDrivenPointerAnalysis::solve() {
+    bool changed;
+    do {
+        changed = false;
+        // NOTE: processing a call via a pointer builds new nodes,
+        // but these are not relevant until they are demanded
+        for (size_t i = 0; i < relevant.size(); ++i)
+            changed |= PTA.processNode(relevant[i]);
+    } while (changed);
+}
+
+void DemandDrivenPointerAnalysis::demandOperands(
+        std::vector<PSNode *> &worklist) {
+    // calls via pointers may have added operands to the relevant nodes
+    // (e.g., to PHI nodes of arguments)
+    for (PSNode *nd : relevant) {
+        for (PSNode *op : nd->getOperands()) {
+            if (op->getID() > PointerGraphReservedIDs::LAST_RESERVED_ID &&
+                !demanded[op->getID()])
+                worklist.push_back(op);
+        }
+    }
+}
+
+void DemandDrivenPointerAnalysis::demandWriters(
+        std::vector<PSNode *> &worklist) {
+    std::unordered_set<PSNode *> readMemory;
+    for (PSNode *nd : readers) {
+        for (const auto &ptr : getReadPointer(nd)->pointsTo)
+            readMemory.insert(getMemoryNode(ptr));
+    }
+
+    if (readMemory.empty())
+        return;
+
+    auto it = writers.begin();
+    for (PSNode *nd : writers) {
+        if (demanded[nd->getID()])
+            continue;
+
+        PSNode *ptr = getWrittenPointer(nd);
+        if (ptr->getID() > PointerGraphReservedIDs::LAST_RESERVED_ID &&
+            !demanded[ptr->getID()]) {
+            // we need to know where it writes
+            worklist.push_back(ptr);
+            *it++ = nd;
+            continue;
+        }
+
+        bool writesRead = false;
+        for (const auto &p : ptr->pointsTo) {
+            if (readMemory.count(getMemoryNode(p)) > 0) {
+                writesRead = true;
+                break;
+            }
+        }
+
+        if (writesRead)
+            worklist.push_back(nd);
+        else
+            *it++ = nd;
+    }
+    writers.erase(it, writers.end());
+}
+
+bool DemandDrivenPointerAnalysis::query(const std::vector<PSNode *> &nodes) {
+    if (exhausted)
+        return false;
+
+    DBG_SECTION_BEGIN(pta, "Demand-driven query for " << nodes.size()
+                                                      << " nodes");
+    if (!initialized)
+        initialize();
+
+    std::vector<PSNode *> worklist(nodes.begin(), nodes.end());
+    do {
+        scanNewNodes(worklist);
+        if (!demand(worklist)) {
+            DBG_SECTION_END(pta, "Exceeded the budget of " << maxNodes
+                                                           << " nodes");
+            exhausted = true;
+            return false;
+        }
+
+        solve();
+
+        scanNewNodes(worklist);
+        demandOperands(worklist);
+        demandWriters(worklist);
+    } while (!worklist.empty());
+
+    DBG_SECTION_END(pta, "Query solved, demanded nodes: " << relevant.size());
+    return true;
+}
+
+} // namespace pta
+} // namespace dg
@@ -10,10 +10,17 @@ namespace pta {
 
 // nodes representing NULL, unknown memory
 // and invalidated memory
-PSNode NULLPTR_LOC(PointerGraphReservedIDs::ID_NULL, PSNodeType::NULL_ADDR);
-PSNode UNKNOWN_MEMLOC(PointerGraphReservedIDs::ID_UNKNOWN,
+static PointsToSetT NULLPTR_PTS;
+static PointsToSetT UNKNOWN_MEMLOC_PTS;
+static PointsToSetT INVALIDATED_PTS;
+
+PSNode NULLPTR_LOC({PointerGraphReservedIDs::ID_NULL, &NULLPTR_PTS},
+                   PSNodeType::NULL_ADDR);
+PSNode UNKNOWN_MEMLOC({PointerGraphReservedIDs::ID_UNKNOWN,
+                       &UNKNOWN_MEMLOC_PTS},
                       PSNodeType::UNKNOWN_MEM);
-PSNode INVALIDATED_LOC(PointerGraphReservedIDs::ID_INVALIDATED,
+PSNode INVALIDATED_LOC({PointerGraphReservedIDs::ID_INVALIDATED,
+                        &INVALIDATED_PTS},
                        PSNodeType::INVALIDATED);
 
 PSNode *NULLPTR = &NULLPTR_LOC;
@@ -52,7 +59,8 @@ void PointerGraph::initStaticNodes() {
 void PointerGraph::computeLoops() {
     DBG(pta, "Computing information about loops for the whole graph");
 
-    for (auto &it : _subgraphs) {
+    for (; _subgraphsWithLoops < _subgraphs.size(); ++_subgraphsWithLoops) {
+        auto &it = _subgraphs[_subgraphsWithLoops];
         if (!it->computedLoops())
             it->computeLoops();
     }
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <map>
+#include <tuple>
+
 #include "dg/PointerAnalysis/PointerGraphOptimizations.h"
 #include "dg/PointerAnalysis/PointerGraph.h"
 
@@ -130,6 +134,187 @@ void PSEquivalentNodesMerger::merge(PSNode *node1, PSNode *node2) {
     ++merged_nodes_num;
 }
 
+PSNode *PSEquivalentPointersMerger::find(PSNode *n) {
+    PSNode *r = n;
+    while (repr[r->getID()] != r)
+        r = repr[r->getID()];
+    // path compression
+    while (repr[n->getID()] != r) {
+        PSNode *next = repr[n->getID()];
+        repr[n->getID()] = r;
+        n = next;
+    }
+    return r;
+}
+
+bool PSEquivalentPointersMerger::canBeMerged(PSNode *n) const {
+    if (open.count(n) > 0)
+        return false;
+
+    switch (n->getType()) {
+    case PSNodeType::CAST:
+    case PSNodeType::GEP:
+    case PSNodeType::PHI:
+    case PSNodeType::CONSTANT:
+        return true;
+    case PSNodeType::LOAD:
+        return mergeLoads;
+    default:
+        return false;
+    }
+}
+
+bool PSEquivalentPointersMerger::numberNodes() {
+    // (type, offset, representants of operands) -> the first node
+    // with this value number
+    using KeyT = std::tuple<PSNodeType, Offset::type, std::vector<PSNode *>>;
+    std::map<KeyT, PSNode *> numbers;
+    bool changed = false;
+
+    for (const auto &nodeptr : G->getNodes()) {
+        if (!nodeptr)
+            continue;
+
+        PSNode *node = nodeptr.get();
+        if (find(node) != node || !canBeMerged(node))
+            continue;
+
+        // the node is equivalent to this one (if not null)
+        PSNode *equiv = nullptr;
+        KeyT key{node->getType(), 0, {}};
+        auto &ops = std::get<2>(key);
+
+        switch (node->getType()) {
+        case PSNodeType::CAST:
+            equiv = find(node->getOperand(0));
+            break;
+        case PSNodeType::GEP: {
+            auto *GEP = PSNodeGep::get(node);
+            if (GEP->getOffset().isZero()) {
+                equiv = find(GEP->getSource());
+            } else {
+                std::get<1>(key) = *GEP->getOffset();
+                ops.push_back(find(GEP->getSource()));
+            }
+            break;
+        }
+        case PSNodeType::PHI:
+            for (PSNode *op : node->getOperands()) {
+                PSNode *r = find(op);
+                if (r != node)
+                    ops.push_back(r);
+            }
+            std::sort(ops.begin(), ops.end());
+            ops.erase(std::unique(ops.begin(), ops.end()), ops.end());
+            // empty phi nodes are handled by PSUnknownsReducer
+            if (ops.empty())
+                continue;
+            if (ops.size() == 1)
+                equiv = ops[0];
+            break;
+        case PSNodeType::CONSTANT: {
+            auto *C = PSNodeConstant::get(node);
+            std::get<1>(key) = *C->getOffset();
+            ops.push_back(C->getTarget());
+            break;
+        }
+        case PSNodeType::LOAD:
+            ops.push_back(find(node->getOperand(0)));
+            break;
+        default:
+            assert(false && "Unhandled node type");
+            abort();
+        }
+
+        if (!equiv) {
+            auto it = numbers.emplace(std::move(key), node);
+            if (it.second)
+                continue;
+            equiv = it.first->second;
+        }
+
+        if (equiv == node)
+            continue;
+
+        repr[node->getID()] = equiv;
+        changed = true;
+    }
+
+    return changed;
+}
+
+// remove duplicate operands from a node whose semantics does not
+// depend on the order of operands (and self-references from phi nodes)
+static void removeRedundantOperands(PSNode *nd) {
+    std::vector<PSNode *> ops;
+    ops.reserve(nd->getOperandsNum());
+    for (PSNode *op : nd->getOperands()) {
+        if (op == nd && nd->getType() == PSNodeType::PHI)
+            continue;
+        if (std::find(ops.begin(), ops.end(), op) == ops.end())
+            ops.push_back(op);
+    }
+
+    if (ops.size() == nd->getOperandsNum())
+        return;
+
+    nd->removeAllOperands();
+    for (PSNode *op : ops)
+        nd->addOperand(op);
+}
+
+void PSEquivalentPointersMerger::applyMerges() {
+    std::vector<PSNode *> merged;
+    for (const auto &nodeptr : G->getNodes()) {
+        if (nodeptr && find(nodeptr.get()) != nodeptr.get())
+            merged.push_back(nodeptr.get());
+    }
+
+    // first disconnect the merged nodes from their operands,
+    // so that they do not show up as users anymore
+    for (PSNode *node : merged)
+        node->removeAllOperands();
+
+    for (PSNode *node : merged) {
+        PSNode *rep = find(node);
+        auto users = node->getUsers();
+        // keep the operands positions (e.g., in stores)
+        node->replaceAllUsesWith(rep, false);
+        for (PSNode *user : users) {
+            auto type = user->getType();
+            if (type == PSNodeType::PHI || type == PSNodeType::CALL_RETURN ||
+                type == PSNodeType::RETURN)
+                removeRedundantOperands(user);
+        }
+
+        removeNode(G, node);
+        mapping.add(node, rep);
+        ++merged_nodes_num;
+    }
+}
+
+unsigned PSEquivalentPointersMerger::run() {
+    repr.resize(G->getNodes().size(), nullptr);
+    for (const auto &nodeptr : G->getNodes()) {
+        if (nodeptr)
+            repr[nodeptr->getID()] = nodeptr.get();
+    }
+    // the static nodes are not stored in the graph
+    for (PSNode *special : {NULLPTR, UNKNOWN_MEMORY, INVALIDATED})
+        repr[special->getID()] = special;
+
+    // global nodes are processed separately before the analysis
+    for (PSNode *glob : G->getGlobals())
+        open.insert(glob);
+
+    // merging some nodes may make other nodes equivalent
+    while (numberNodes())
+        ;
+
+    applyMerges();
+    return merged_nodes_num;
+}
+
 unsigned PSNoopRemover::run() {
     unsigned removed = 0;
     for (const auto &nd : G->getNodes()) {
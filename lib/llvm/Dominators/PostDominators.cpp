@@ -1,3 +1,7 @@
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <llvm/Analysis/PostDominators.h>
 #include <llvm/IR/Function.h>
 
@@ -6,105 +10,129 @@
 
 #include "dg/llvm/LLVMDependenceGraph.h"
 #include "dg/util/debug.h"
+#include "dg/util/parallel.h"
 
 namespace dg {
 
-void LLVMDependenceGraph::computePostDominators(bool addPostDomFrontiers) {
-    DBG_SECTION_BEGIN(llvmdg,
-                      "Computing post-dominator frontiers (control deps.)");
-    using namespace llvm;
-    // iterate over all functions
-    for (const auto &F : getConstructedFunctions()) {
-        legacy::PostDominanceFrontiers<LLVMNode, LLVMBBlock> pdfrontiers;
+namespace {
 
-        // root of post-dominator tree
-        LLVMBBlock *root = nullptr;
-        Value *val = const_cast<Value *>(F.first);
-        Function &f = *cast<Function>(val);
-        PostDominatorTree *pdtree;
+// compute post-dominator tree of the function and store it into
+// the blocks of the graph. Return false if the tree was not built.
+bool computePostDominatorTree(llvm::Function &f, LLVMDependenceGraph *graph) {
+    using namespace llvm;
 
-        DBG_SECTION_BEGIN(llvmdg,
-                          "Computing control deps. for " << f.getName().str());
+    PostDominatorTree *pdtree;
 
 #if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
-        pdtree = new PostDominatorTree();
-        // compute post-dominator tree for this function
-        pdtree->runOnFunction(f);
+    std::unique_ptr<PostDominatorTree> pdtreeptr(new PostDominatorTree());
+    pdtree = pdtreeptr.get();
+    // compute post-dominator tree for this function
+    pdtree->runOnFunction(f);
 #else
-        PostDominatorTreeWrapperPass wrapper;
-        wrapper.runOnFunction(f);
-        pdtree = &wrapper.getPostDomTree();
+    PostDominatorTreeWrapperPass wrapper;
+    wrapper.runOnFunction(f);
+    pdtree = &wrapper.getPostDomTree();
 #ifndef NDEBUG
-        wrapper.verifyAnalysis();
+    wrapper.verifyAnalysis();
 #endif
 #endif
 
-        // add immediate post-dominator edges
-        auto &our_blocks = F.second->getBlocks();
-        bool built = false;
-        for (auto &it : our_blocks) {
-            LLVMBBlock *BB = it.second;
-            BasicBlock *B = cast<BasicBlock>(const_cast<Value *>(it.first));
-            DomTreeNode *N = pdtree->getNode(B);
-            // when function contains infinite loop, we're screwed
-            // and we don't have anything
-            // FIXME: just check for the root,
-            // don't iterate over all blocks, stupid...
-            if (!N)
-                continue;
-
-            DomTreeNode *idom = N->getIDom();
-            BasicBlock *idomBB = idom ? idom->getBlock() : nullptr;
-            built = true;
-
-            if (idomBB) {
-                LLVMBBlock *pb = our_blocks[idomBB];
-                assert(pb && "Do not have constructed BB");
-                BB->setIPostDom(pb);
-                assert(cast<BasicBlock>(BB->getKey())->getParent() ==
-                               cast<BasicBlock>(pb->getKey())->getParent() &&
-                       "BBs are from diferent functions");
-                // if we do not have idomBB, then the idomBB is a root BB
-            } else {
-                // PostDominatorTree may has special root without BB set
-                // or it is the node without immediate post-dominator
-                if (!root) {
-                    root = new LLVMBBlock();
-                    root->setKey(nullptr);
-                    F.second->setPostDominatorTreeRoot(root);
-                }
-
-                BB->setIPostDom(root);
+    // root of post-dominator tree
+    LLVMBBlock *root = nullptr;
+    // add immediate post-dominator edges
+    auto &our_blocks = graph->getBlocks();
+    bool built = false;
+    for (auto &it : our_blocks) {
+        LLVMBBlock *BB = it.second;
+        BasicBlock *B = cast<BasicBlock>(const_cast<Value *>(it.first));
+        DomTreeNode *N = pdtree->getNode(B);
+        // when function contains infinite loop, we're screwed
+        // and we don't have anything
+        // FIXME: just check for the root,
+        // don't iterate over all blocks, stupid...
+        if (!N)
+            continue;
+
+        DomTreeNode *idom = N->getIDom();
+        BasicBlock *idomBB = idom ? idom->getBlock() : nullptr;
+        built = true;
+
+        if (idomBB) {
+            auto pit = our_blocks.find(idomBB);
+            assert(pit != our_blocks.end() && "Do not have constructed BB");
+            LLVMBBlock *pb = pit->second;
+            BB->setIPostDom(pb);
+            assert(cast<BasicBlock>(BB->getKey())->getParent() ==
+                           cast<BasicBlock>(pb->getKey())->getParent() &&
+                   "BBs are from diferent functions");
+            // if we do not have idomBB, then the idomBB is a root BB
+        } else {
+            // PostDominatorTree may has special root without BB set
+            // or it is the node without immediate post-dominator
+            if (!root) {
+                root = new LLVMBBlock();
+                root->setKey(nullptr);
+                graph->setPostDominatorTreeRoot(root);
             }
+
+            BB->setIPostDom(root);
         }
+    }
+
+    return built;
+}
+
+void computePostDominators(llvm::Function &f, LLVMDependenceGraph *graph,
+                           bool addPostDomFrontiers) {
+    bool built = computePostDominatorTree(f, graph);
 
-        // well, if we haven't built the pdtree, this is probably infinite loop
-        // that has no pdtree. Until we have anything better, just add sound
-        // control edges that are not so precise - to predecessors.
-        if (!built && addPostDomFrontiers) {
-            for (auto &it : our_blocks) {
-                LLVMBBlock *BB = it.second;
-                for (const LLVMBBlock::BBlockEdge &succ : BB->successors()) {
-                    // in this case we add only the control dependencies,
-                    // since we have no pd frontiers
-                    BB->addControlDependence(succ.target);
-                }
+    // well, if we haven't built the pdtree, this is probably infinite loop
+    // that has no pdtree. Until we have anything better, just add sound
+    // control edges that are not so precise - to predecessors.
+    if (!built && addPostDomFrontiers) {
+        for (auto &it : graph->getBlocks()) {
+            LLVMBBlock *BB = it.second;
+            for (const LLVMBBlock::BBlockEdge &succ : BB->successors()) {
+                // in this case we add only the control dependencies,
+                // since we have no pd frontiers
+                BB->addControlDependence(succ.target);
             }
         }
+    }
 
-        if (addPostDomFrontiers) {
-            // assert(root && "BUG: must have root");
-            if (root)
-                pdfrontiers.compute(root,
-                                    true /* store also control depend. */);
+    if (addPostDomFrontiers) {
+        // assert(root && "BUG: must have root");
+        if (auto *root = graph->getPostDominatorTreeRoot()) {
+            legacy::PostDominanceFrontiers<LLVMNode, LLVMBBlock> pdfrontiers;
+            pdfrontiers.compute(root, true /* store also control depend. */);
         }
+    }
+}
 
-#if ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR < 9))
-        delete pdtree;
-#endif
-        DBG_SECTION_END(llvmdg, "Done computing control deps. for "
-                                        << f.getName().str());
+} // anonymous namespace
+
+void LLVMDependenceGraph::computePostDominators(bool addPostDomFrontiers,
+                                                unsigned workers) {
+    DBG_SECTION_BEGIN(llvmdg,
+                      "Computing post-dominator frontiers (control deps.)");
+    using namespace llvm;
+
+    // the post-dominators and frontiers of a function are stored only
+    // into the blocks of the function, so we can compute them
+    // for all functions in parallel
+    std::vector<std::pair<Function *, LLVMDependenceGraph *>> funs;
+    for (const auto &F : getConstructedFunctions()) {
+        Value *val = const_cast<Value *>(F.first);
+        funs.emplace_back(cast<Function>(val), F.second);
     }
+
+    auto compute = [&funs, addPostDomFrontiers](size_t i, unsigned /* id */) {
+        dg::computePostDominators(*funs[i].first, funs[i].second,
+                                  addPostDomFrontiers);
+    };
+    parallelFor(funs.size(), workers, compute);
+
+    DBG(llvmdg, "Computed post-dominators of " << funs.size() << " functions");
     DBG_SECTION_END(llvmdg,
                     "Done computing post-dominator frontiers (control deps.)");
 }
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include "dg/llvm/LLVMDG2Binary.h"
+#include "dg/llvm/LLVMDependenceGraph.h"
+
+#include "llvm/ValueIds.h"
+
+namespace dg {
+
+namespace {
+
+using binary::EdgeKind;
+using binary::NodeKind;
+using llvmutils::ValueIds;
+using llvmutils::ValueRef;
+
+class LLVMDGBinaryWriter {
+    const ValueIds &_ids;
+    binary::BinaryGraphWriter _writer;
+    std::unordered_map<const LLVMNode *, uint32_t> _nodes;
+
+    using RankT = std::tuple<unsigned, unsigned, unsigned, unsigned>;
+
+    // The graphs are stored in maps keyed by pointers. Sort the values
+    // so that the numbering of nodes does not depend on the addresses:
+    // the values from 'order' go first (the arguments of a function or
+    // the operands of a call) and then the values by their identifiers.
+    RankT getRank(const llvm::Value *val,
+                  const std::vector<const llvm::Value *> &order) const {
+        auto it = std::find(order.begin(), order.end(), val);
+        if (it != order.end())
+            return RankT{0, it - order.begin(), 0, 0};
+        ValueRef ref;
+        if (_ids.get(val, ref))
+            return RankT{1, static_cast<unsigned>(ref.kind), ref.name,
+                         ref.index};
+        return RankT{2, 0, 0, 0};
+    }
+
+    template <typename T>
+    std::vector<std::pair<const llvm::Value *, T>>
+    sorted(std::vector<std::pair<const llvm::Value *, T>> values,
+           const std::vector<const llvm::Value *> &order = {}) const {
+        std::vector<std::pair<RankT, size_t>> ranks;
+        ranks.reserve(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            ranks.emplace_back(getRank(values[i].first, order), i);
+        std::stable_sort(ranks.begin(), ranks.end());
+
+        std::vector<std::pair<const llvm::Value *, T>> ret;
+        ret.reserve(values.size());
+        for (const auto &it : ranks)
+            ret.push_back(values[it.second]);
+        return ret;
+    }
+
+    void addNode(const LLVMNode *node, NodeKind kind,
+                 uint32_t owner = binary::NONE) {
+        if (!node || _nodes.count(node) > 0)
+            return;
+
+        binary::NodeRecord rec;
+        rec.kind = kind;
+        rec.owner = owner;
+        ValueRef ref;
+        if (_ids.get(node->getKey(), ref)) {
+            // the numbering of kinds is the same
+            rec.valueKind = static_cast<binary::ValueKind>(ref.kind);
+            rec.name = ref.name;
+            rec.index = ref.index;
+        }
+        _nodes[node] = _writer.addNode(rec);
+    }
+
+    void addParameters(DGParameters<LLVMNode> *params,
+                       const std::vector<const llvm::Value *> &order,
+                       uint32_t owner) {
+        if (!params)
+            return;
+
+        std::vector<std::pair<const llvm::Value *, DGParameterPair<LLVMNode> *>>
+                pairs;
+        for (auto &it : *params)
+            pairs.emplace_back(it.first, &it.second);
+        for (auto I = params->global_begin(), E = params->global_end(); I != E;
+             ++I)
+            pairs.emplace_back(I->first, &I->second);
+
+        for (auto &it : sorted(std::move(pairs), order)) {
+            addNode(it.second->in, NodeKind::PARAMETER_IN, owner);
+            addNode(it.second->out, NodeKind::PARAMETER_OUT, owner);
+        }
+        if (auto *va = params->getVarArg()) {
+            addNode(va->in, NodeKind::PARAMETER_IN, owner);
+            addNode(va->out, NodeKind::PARAMETER_OUT, owner);
+        }
+        addNode(params->getNoReturn(), NodeKind::NORETURN, owner);
+    }
+
+    void addFunction(const llvm::Function &F, LLVMDependenceGraph *graph) {
+        auto fun = _writer.addFunction(getNameId(F));
+        addNode(graph->getEntry(), NodeKind::VALUE);
+        if (graph->getEntry())
+            _writer.setEntry(fun, _nodes[graph->getEntry()]);
+
+        std::vector<const llvm::Value *> args;
+        for (const auto &A : F.args())
+            args.push_back(&A);
+        addParameters(graph->getParameters(), args, binary::NONE);
+
+        std::vector<std::pair<const llvm::Value *, LLVMNode *>> nodes;
+        for (auto &it : *graph)
+            nodes.emplace_back(it.first, it.second);
+        for (auto &it : sorted(std::move(nodes))) {
+            addNode(it.second, NodeKind::VALUE);
+
+            std::vector<const llvm::Value *> operands;
+            if (const auto *I = llvm::dyn_cast<llvm::Instruction>(it.first)) {
+                for (const auto &op : I->operands())
+                    operands.push_back(op.get());
+            }
+            addParameters(it.second->getParameters(), operands,
+                          _nodes[it.second]);
+        }
+
+        if (auto *exit = graph->getExit())
+            addNode(exit, NodeKind::ARTIFICIAL);
+    }
+
+    uint32_t getNameId(const llvm::Function &F) const {
+        ValueRef ref;
+        return _ids.get(&F, ref) ? ref.name : binary::NONE;
+    }
+
+    void addEdges(const LLVMNode *n, uint32_t id) {
+        // the edges from 'n', skip the nodes
+        // that are not in any graph
+        auto to = [&](EdgeKind kind, const LLVMNode *dst) {
+            auto it = _nodes.find(dst);
+            if (it != _nodes.end())
+                _writer.addEdge(kind, id, it->second);
+        };
+
+        for (auto I = n->control_begin(), E = n->control_end(); I != E; ++I)
+            to(EdgeKind::CONTROL, *I);
+        for (auto I = n->data_begin(), E = n->data_end(); I != E; ++I)
+            to(EdgeKind::DATA, *I);
+        // the users of the value of 'n'
+        for (auto I = n->use_begin(), E = n->use_end(); I != E; ++I)
+            to(EdgeKind::USE, *I);
+        for (auto I = n->interference_begin(), E = n->interference_end();
+             I != E; ++I)
+            to(EdgeKind::INTERFERENCE, *I);
+        for (auto *subgraph : n->getSubgraphs())
+            to(EdgeKind::CALL, subgraph->getEntry());
+
+        // control dependencies of blocks
+        auto *BB = n->getBBlock();
+        if (!BB || BB->getLastNode() != n)
+            return;
+        for (auto *S : BB->controlDependence()) {
+            for (auto *dst : S->getNodes())
+                to(EdgeKind::CONTROL, dst);
+        }
+    }
+
+  public:
+    LLVMDGBinaryWriter(const ValueIds &ids) : _ids(ids) {}
+
+    bool write(const llvm::Module &M, const std::string &path) {
+        const auto &CF = getConstructedFunctions();
+
+        // the entry nodes are global nodes,
+        // but we want to have them in their functions
+        std::unordered_set<const LLVMNode *> entries;
+        for (const auto &it : CF)
+            entries.insert(it.second->getEntry());
+
+        // global nodes are shared by the graphs
+        std::vector<std::pair<const llvm::Value *, LLVMNode *>> globals;
+        std::unordered_set<const void *> seen;
+        for (const auto &it : CF) {
+            const auto &G = it.second->getGlobalNodes();
+            if (!G || !seen.insert(G.get()).second)
+                continue;
+            for (auto &git : *G) {
+                if (entries.count(git.second) == 0)
+                    globals.emplace_back(git.first, git.second);
+            }
+        }
+        for (auto &it : sorted(std::move(globals)))
+            addNode(it.second, NodeKind::VALUE);
+
+        for (const auto &F : M) {
+            auto it = CF.find(const_cast<llvm::Function *>(&F));
+            if (it != CF.end())
+                addFunction(F, it->second);
+        }
+
+        for (const auto &it : _nodes)
+            addEdges(it.first, it.second);
+
+        _writer.setNames(_ids.getNames());
+        return _writer.write(path);
+    }
+};
+
+} // anonymous namespace
+
+bool writeBinaryGraph(LLVMDependenceGraph *dg, const std::string &path) {
+    const auto *M = dg->getModule();
+    if (!M)
+        return false;
+
+    ValueIds ids(*M);
+    return LLVMDGBinaryWriter(ids).write(*M, path);
+}
+
+} // namespace dg
@@ -0,0 +1,314 @@
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "dg/llvm/LLVMDGAssemblyAnnotationWriter.h"
+#include "dg/util/parallel.h"
+
+namespace dg {
+namespace debug {
+
+namespace {
+
+void printValue(const llvm::Value *val, llvm::raw_ostream &os,
+                LLVMValueFormatter &formatter) {
+    if (val->hasName())
+        os << val->getName();
+    else
+        formatter.print(os, val);
+}
+
+void printPointer(const LLVMPointer &ptr, llvm::raw_ostream &os,
+                  LLVMValueFormatter &formatter) {
+    os << "  ; PTR: ";
+    printValue(ptr.value, os, formatter);
+
+    os << " + ";
+    if (ptr.offset.isUnknown())
+        os << "?";
+    else
+        os << *ptr.offset;
+    os << "\n";
+}
+
+void printMemRegion(const LLVMMemoryRegion &R, llvm::raw_ostream &os,
+                    LLVMValueFormatter &formatter) {
+    os << "  ; ";
+
+    assert(R.pointer.value);
+    printValue(R.pointer.value, os, formatter);
+
+    if (R.pointer.offset.isUnknown())
+        os << " bytes [?";
+    else
+        os << " bytes [" << *R.pointer.offset;
+
+    if (R.len.isUnknown())
+        os << " - ?]";
+    else
+        os << " - " << *R.pointer.offset + *R.len - 1 << "]";
+    os << "\n";
+}
+
+// the results of pointer analysis copied out of the analysis,
+// so that they can be printed without holding the lock
+struct PointsTo {
+    std::vector<LLVMPointer> pointers;
+    bool null{false};
+    bool nullWithOffset{false};
+    bool unknown{false};
+    bool invalidated{false};
+};
+
+bool containsSlice(LLVMDependenceGraph *graph) {
+    for (auto &it : *graph) {
+        if (it.second->getSlice() != 0)
+            return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+void LLVMDGAssemblyAnnotationWriter::emitNodeAnnotations(
+        LLVMNode *node, llvm::raw_ostream &os, LLVMValueFormatter &formatter) {
+    using namespace llvm;
+
+    if (opts & ANNOTATE_DEF) {
+        assert(DDA && "No data dependence analysis");
+        std::vector<llvm::Value *> defs;
+        bool isUse;
+        {
+            std::lock_guard<std::mutex> guard(analysesLock);
+            isUse = DDA->isUse(node->getValue());
+            if (isUse)
+                defs = DDA->getLLVMDefinitions(node->getValue());
+        }
+
+        if (isUse) {
+            os << "  ; DEF: ";
+            if (defs.empty()) {
+                os << "none (or global)\n";
+            } else {
+                for (auto *def : defs) {
+                    printValue(def, os, formatter);
+                    os << "(" << def << ")\n";
+                }
+            }
+        }
+    }
+
+    if (opts & ANNOTATE_DD) {
+        for (auto I = node->rev_data_begin(), E = node->rev_data_end(); I != E;
+             ++I) {
+            const llvm::Value *d = (*I)->getKey();
+            os << "  ; DD: ";
+            printValue(d, os, formatter);
+            os << "(" << d << ")\n";
+        }
+    }
+
+    if (opts & ANNOTATE_FORWARD_DD) {
+        for (auto I = node->data_begin(), E = node->data_end(); I != E; ++I) {
+            const llvm::Value *d = (*I)->getKey();
+            os << "  ; fDD: ";
+            formatter.print(os, d);
+            os << "(" << d << ")\n";
+        }
+    }
+
+    if (opts & ANNOTATE_CD) {
+        for (auto I = node->rev_control_begin(), E = node->rev_control_end();
+             I != E; ++I) {
+            os << "  ; rCD: ";
+            printValue((*I)->getKey(), os, formatter);
+            os << "\n";
+        }
+    }
+
+    if ((opts & ANNOTATE_PTR) && PTA) {
+        llvm::Type *Ty = node->getKey()->getType();
+        if (Ty->isPointerTy() || Ty->isIntegerTy()) {
+            PointsTo pts;
+            {
+                std::lock_guard<std::mutex> guard(analysesLock);
+                const auto &ps = PTA->getLLVMPointsTo(node->getKey());
+                if (!ps.empty()) {
+                    for (const auto &llvmptr : ps)
+                        pts.pointers.push_back(llvmptr);
+                    pts.null = ps.hasNull();
+                    pts.nullWithOffset = ps.hasNullWithOffset();
+                    pts.unknown = ps.hasUnknown();
+                    pts.invalidated = ps.hasInvalidated();
+                }
+            }
+
+            for (const auto &ptr : pts.pointers)
+                printPointer(ptr, os, formatter);
+            if (pts.null)
+                os << "  ; null\n";
+            if (pts.nullWithOffset)
+                os << "  ; null + ?\n";
+            if (pts.unknown)
+                os << "  ; unknown\n";
+            if (pts.invalidated)
+                os << "  ; invalidated\n";
+        }
+    }
+
+    if (PTA && (opts & ANNOTATE_MEMORYACC)) {
+        if (auto *I = dyn_cast<Instruction>(node->getValue())) {
+            if (I->mayReadOrWriteMemory()) {
+                std::pair<bool, LLVMMemoryRegionSet> regions;
+                {
+                    std::lock_guard<std::mutex> guard(analysesLock);
+                    regions = PTA->getAccessedMemory(I);
+                }
+                if (regions.first) {
+                    os << "  ; unknown region\n";
+                }
+                for (const auto &mem : regions.second) {
+                    printMemRegion(mem, os, formatter);
+                }
+            }
+        }
+    }
+
+    if (opts & ANNOTATE_SLICE) {
+        if (criteria && criteria->count(node) > 0)
+            os << "  ; SLICING CRITERION\n";
+        if (node->getSlice() == 0)
+            os << "  ; x ";
+    }
+}
+
+void LLVMDGAssemblyAnnotationWriter::emitBlockAnnotations(
+        LLVMBBlock *BB, llvm::raw_ostream &os) {
+    if (opts & (ANNOTATE_POSTDOM | ANNOTATE_CD))
+        os << "  ; BB: " << BB << "\n";
+
+    if (opts & ANNOTATE_POSTDOM) {
+        for (LLVMBBlock *p : BB->getPostDomFrontiers())
+            os << "  ; PDF: " << p << "\n";
+
+        LLVMBBlock *P = BB->getIPostDom();
+        if (P && P->getKey())
+            os << "  ; iPD: " << P << "\n";
+    }
+
+    if (opts & ANNOTATE_CD) {
+        for (LLVMBBlock *p : BB->controlDependence())
+            os << "  ; CD: " << p << "\n";
+    }
+}
+
+void LLVMDGAssemblyAnnotationWriter::annotateFunction(
+        const llvm::Function &F, LLVMDependenceGraph *graph,
+        FunctionAnnotations &annot, LLVMValueFormatter &formatter) {
+    llvm::raw_string_ostream os(annot.text);
+    auto finish = [&annot, &os]() {
+        os.flush();
+        annot.ends.push_back(annot.text.size());
+    };
+
+    // the same order as in prepare()
+    for (const auto &B : F) {
+        if (graph) {
+            auto &blocks = graph->getBlocks();
+            auto it = blocks.find(const_cast<llvm::BasicBlock *>(&B));
+            if (it != blocks.end())
+                emitBlockAnnotations(it->second, os);
+        }
+        finish();
+
+        for (const auto &I : B) {
+            auto *val = const_cast<llvm::Instruction *>(&I);
+            auto *node = graph ? graph->getNode(val) : nullptr;
+            if (node)
+                emitNodeAnnotations(node, os, formatter);
+            else if (opts & ANNOTATE_SLICE)
+                os << "  ; x ";
+            finish();
+        }
+    }
+}
+
+void LLVMDGAssemblyAnnotationWriter::prepare(const llvm::Module &M,
+                                             unsigned workers) {
+    prepared = true;
+    annotations.clear();
+    index.clear();
+    if (opts == 0)
+        return;
+
+    const auto &CF = getConstructedFunctions();
+    std::vector<std::pair<const llvm::Function *, LLVMDependenceGraph *>> funs;
+    for (const auto &F : M) {
+        if (F.isDeclaration())
+            continue;
+
+        auto it = CF.find(const_cast<llvm::Function *>(&F));
+        auto *graph = it == CF.end() ? nullptr : it->second;
+        if (only_sliced && (!graph || !containsSlice(graph)))
+            continue;
+
+        uint32_t fun = funs.size();
+        uint32_t idx = 0;
+        for (const auto &B : F) {
+            index[&B] = {fun, idx++};
+            for (const auto &I : B)
+                index[&I] = {fun, idx++};
+        }
+        funs.emplace_back(&F, graph);
+    }
+
+    annotations.resize(funs.size());
+    // the formatter is not thread-safe, every worker has its own
+    workers = getWorkersNum(workers, funs.size());
+    std::vector<LLVMValueFormatter> formatters(workers);
+    auto annotate = [this, &funs, &formatters](size_t i, unsigned id) {
+        annotateFunction(*funs[i].first, funs[i].second, annotations[i],
+                         formatters[id]);
+    };
+    parallelFor(funs.size(), workers, annotate);
+}
+
+void LLVMDGAssemblyAnnotationWriter::emitAnnotation(const llvm::Value *val,
+                                                    llvm::raw_ostream &os) {
+    auto it = index.find(val);
+    if (it == index.end())
+        return;
+
+    const auto &annot = annotations[it->second.first];
+    uint32_t idx = it->second.second;
+    uint32_t begin = idx == 0 ? 0 : annot.ends[idx - 1];
+    os.write(annot.text.data() + begin, annot.ends[idx] - begin);
+}
+
+void LLVMDGAssemblyAnnotationWriter::emitFunctionAnnot(
+        const llvm::Function *F, llvm::formatted_raw_ostream &os) {
+    if (!prepared)
+        prepare(*F->getParent());
+
+    // dump the slicer's setting to the file
+    // for easier comprehension
+    if (!module_comment_emitted) {
+        module_comment_emitted = true;
+        os << module_comment;
+    }
+}
+
+void LLVMDGAssemblyAnnotationWriter::emitInstructionAnnot(
+        const llvm::Instruction *I, llvm::formatted_raw_ostream &os) {
+    emitAnnotation(I, os);
+}
+
+void LLVMDGAssemblyAnnotationWriter::emitBasicBlockStartAnnot(
+        const llvm::BasicBlock *B, llvm::formatted_raw_ostream &os) {
+    emitAnnotation(B, os);
+}
+
+} // namespace debug
+} // namespace dg
@@ -1,6 +1,7 @@
 #include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <llvm/Config/llvm-config.h>
 
@@ -54,6 +55,14 @@ getConstructedFunctions() {
 }
 
 LLVMDependenceGraph::~LLVMDependenceGraph() {
+    // unregister the graph, so that a graph built later
+    // (e.g., for another module) does not find the dangling pointer
+    if (auto *entry = getEntry()) {
+        auto it = constructedFunctions.find(entry->getKey());
+        if (it != constructedFunctions.end() && it->second == this)
+            constructedFunctions.erase(it);
+    }
+
     // delete nodes
     for (auto &I : *this) {
         LLVMNode *node = I.second;
@@ -1069,46 +1078,88 @@ void LLVMDependenceGraph::computeCriticalSections(
     }
 }
 
+static LLVMNode *findInstructionNode(
+        const llvm::Instruction *inst,
+        const std::map<llvm::Value *, LLVMDependenceGraph *> &functions) {
+    auto function = functions.find(
+            const_cast<llvm::Function *>(inst->getParent()->getParent()));
+    if (function == functions.end())
+        return nullptr;
+    return function->second->findNode(const_cast<llvm::Instruction *>(inst));
+}
+
 void LLVMDependenceGraph::computeInterferenceDependentEdges(
         const std::set<const llvm::Instruction *> &loads,
         const std::set<const llvm::Instruction *> &stores) {
-    for (const auto &load : loads) {
-        auto *loadInst = const_cast<llvm::Instruction *>(load);
-        auto loadFunction = constructedFunctions.find(
-                const_cast<llvm::Function *>(load->getParent()->getParent()));
-        if (loadFunction == constructedFunctions.end())
+    struct StoreInfo {
+        const llvm::Instruction *store;
+        LLVMNode *node;
+        uint64_t len;
+        // the last load that was checked against this store
+        const llvm::Instruction *lastLoad{nullptr};
+    };
+
+    const auto &DL = getModule()->getDataLayout();
+    // find the nodes of stores only once, not for every load again,
+    // and index the stores by the memory they may write to, so that
+    // we query aliasing only for the loads and stores that may access
+    // the same object instead of for all the pairs
+    std::vector<StoreInfo> storeInfos;
+    std::unordered_map<const llvm::Value *, std::vector<size_t>> storesOf;
+    std::vector<size_t> unknownStores;
+    storeInfos.reserve(stores.size());
+    for (const auto &store : stores) {
+        auto *storeNode = findInstructionNode(store, constructedFunctions);
+        if (!storeNode)
             continue;
-        auto *loadNode = loadFunction->second->findNode(loadInst);
-        if (!loadNode)
+
+        size_t idx = storeInfos.size();
+        storeInfos.push_back({store, storeNode,
+                              llvmutils::getAllocatedSize(
+                                      store->getOperand(0)->getType(), &DL)});
+        auto pts = PTA->getLLVMPointsTo(store->getOperand(1));
+        if (pts.hasUnknown()) {
+            unknownStores.push_back(idx);
             continue;
+        }
+        for (const auto &ptr : pts)
+            storesOf[ptr.value].push_back(idx);
+    }
 
-        for (const auto &store : stores) {
-            auto *storeInst = const_cast<llvm::Instruction *>(store);
-            auto storeFunction =
-                    constructedFunctions.find(const_cast<llvm::Function *>(
-                            store->getParent()->getParent()));
-            if (storeFunction == constructedFunctions.end())
-                continue;
-            auto *storeNode = storeFunction->second->findNode(storeInst);
-            if (!storeNode)
-                continue;
+    if (storeInfos.empty())
+        return;
 
-            auto loadPts = PTA->getLLVMPointsTo(load->getOperand(0));
-            auto storePts = PTA->getLLVMPointsTo(store->getOperand(1));
-            for (const auto &pointerLoad : loadPts) {
-                for (const auto &pointerStore : storePts) {
-                    if (pointerLoad.value == pointerStore.value &&
-                        (pointerLoad.offset.isUnknown() ||
-                         pointerStore.offset.isUnknown() ||
-                         pointerLoad.offset == pointerStore.offset)) {
-                        storeNode->addInterferenceDependence(loadNode);
-                    }
-                }
-            }
+    for (const auto &load : loads) {
+        auto *loadNode = findInstructionNode(load, constructedFunctions);
+        if (!loadNode)
+            continue;
 
-            // handle the unknown pointer
-            if (loadPts.hasUnknown() || storePts.hasUnknown())
-                storeNode->addInterferenceDependence(loadNode);
+        auto loadLen = llvmutils::getAllocatedSize(load->getType(), &DL);
+        auto check = [&](size_t idx) {
+            auto &info = storeInfos[idx];
+            if (info.lastLoad == load)
+                return;
+            info.lastLoad = load;
+            if (PTA->mayAlias(load->getOperand(0), loadLen,
+                              info.store->getOperand(1), info.len))
+                info.node->addInterferenceDependence(loadNode);
+        };
+
+        auto pts = PTA->getLLVMPointsTo(load->getOperand(0));
+        if (pts.hasUnknown()) {
+            for (size_t idx = 0; idx < storeInfos.size(); ++idx)
+                check(idx);
+            continue;
+        }
+
+        for (auto idx : unknownStores)
+            check(idx);
+        for (const auto &ptr : pts) {
+            auto it = storesOf.find(ptr.value);
+            if (it == storesOf.end())
+                continue;
+            for (auto idx : it->second)
+                check(idx);
         }
     }
 }
@@ -1141,7 +1192,7 @@ std::set<const llvm::Instruction *> LLVMDependenceGraph::getInstructionsOfType(
 void LLVMDependenceGraph::computeControlDependencies(
         const LLVMControlDependenceAnalysisOptions &opts) {
     if (opts.standardCD()) {
-        computePostDominators(true);
+        computePostDominators(true, opts.workers);
     } else if (opts.ntscdLegacyCD()) {
         computeNonTerminationControlDependencies();
         // the legacy implementation contains a bug, we workaroudn it by running
@@ -1,3 +1,7 @@
+#include <utility>
+#include <vector>
+
+#include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/Instruction.h>
 
 #include "dg/llvm/PointerAnalysis/PointerAnalysis.h"
@@ -110,4 +114,177 @@ LLVMPointerAnalysis::getAccessedMemory(const llvm::Instruction *I) {
     return {PTSet.hasUnknown(), regions};
 }
 
+// length 0 means that we do not know the length
+static inline Offset normalizeLength(Offset len) {
+    return len == 0 ? Offset::UNKNOWN : len;
+}
+
+// do the intervals [o1, o1 + l1) and [o2, o2 + l2) overlap?
+static bool intervalsOverlap(Offset o1, Offset l1, Offset o2, Offset l2) {
+    if (o1.isUnknown() || o2.isUnknown())
+        return true;
+
+    if (o2 < o1) {
+        std::swap(o1, o2);
+        std::swap(l1, l2);
+    }
+
+    return l1.isUnknown() || *o1 + *l1 > *o2;
+}
+
+template <typename PTSetT1, typename PTSetT2>
+static bool pointsToSetsOverlap(const PTSetT1 &pts1, Offset len1,
+                                const PTSetT2 &pts2, Offset len2) {
+    for (const auto &ptr1 : pts1) {
+        for (const auto &ptr2 : pts2) {
+            if (ptr1.value == ptr2.value &&
+                intervalsOverlap(ptr1.offset, len1, ptr2.offset, len2))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+// we know that the memory overlaps, can we say it is must-alias?
+// A global variable is the only allocation site that is surely
+// a single object (locals and heap objects may be allocated repeatedly)
+template <typename PTSetT>
+static AliasResult aliasOfOverlapping(const PTSetT &pts1, const PTSetT &pts2) {
+    if (pts1.isKnownSingleton() && pts2.isKnownSingleton()) {
+        auto ptr1 = pts1.getKnownSingleton();
+        auto ptr2 = pts2.getKnownSingleton();
+        if (ptr1 == ptr2 && !ptr1.offset.isUnknown() &&
+            llvm::isa<llvm::GlobalVariable>(ptr1.value))
+            return AliasResult::MustAlias;
+    }
+
+    return AliasResult::MayAlias;
+}
+
+AliasResult LLVMPointerAnalysis::alias(const llvm::Value *v1, Offset len1,
+                                       const llvm::Value *v2, Offset len2) {
+    if (v1 == v2)
+        return AliasResult::MustAlias;
+
+    auto pts1 = getLLVMPointsTo(v1);
+    auto pts2 = getLLVMPointsTo(v2);
+    if (pts1.hasUnknown() || pts2.hasUnknown())
+        return AliasResult::MayAlias;
+
+    // LLVMPointsToSet can be iterated only once,
+    // so we need a copy of the set for the inner loop
+    std::vector<LLVMPointer> ptrs2;
+    for (const auto &ptr : pts2)
+        ptrs2.push_back(ptr);
+
+    if (!pointsToSetsOverlap(pts1, normalizeLength(len1), ptrs2,
+                             normalizeLength(len2)))
+        return AliasResult::NoAlias;
+
+    return aliasOfOverlapping(pts1, pts2);
+}
+
+// do the points-to sets contain the same (valid) pointer?
+static bool sharePointer(const PointsToSetT &pts1, const PointsToSetT &pts2) {
+    const auto &smaller = pts1.size() <= pts2.size() ? pts1 : pts2;
+    const auto &bigger = pts1.size() <= pts2.size() ? pts2 : pts1;
+    for (const auto &ptr : smaller) {
+        if (ptr.isValid() && !ptr.isInvalidated() && bigger.pointsTo(ptr))
+            return true;
+    }
+    return false;
+}
+
+AliasResult DGLLVMPointerAnalysis::alias(const llvm::Value *v1, Offset len1,
+                                         const llvm::Value *v2, Offset len2) {
+    if (v1 == v2)
+        return AliasResult::MustAlias;
+
+    PSNode *n1 = getPointsToNode(v1);
+    PSNode *n2 = getPointsToNode(v2);
+    if (!n1 || !n2 || n1->pointsTo.empty() || n2->pointsTo.empty())
+        return AliasResult::MayAlias;
+
+    len1 = normalizeLength(len1);
+    len2 = normalizeLength(len2);
+    // the query is symmetric
+    if (n2->getID() < n1->getID()) {
+        std::swap(n1, n2);
+        std::swap(len1, len2);
+    }
+
+    if (_aliasCache.empty())
+        _aliasCache.resize(ALIAS_CACHE_SIZE);
+
+    size_t hash = n1->getID() * 0x9e3779b1U;
+    hash ^= n2->getID() + 0x7f4a7c15U + (hash << 6) + (hash >> 2);
+    hash ^= *len1 + (hash << 6) + (hash >> 2);
+    hash ^= *len2 + (hash << 6) + (hash >> 2);
+    auto &entry = _aliasCache[hash & (ALIAS_CACHE_SIZE - 1)];
+    if (entry.id1 == n1->getID() && entry.id2 == n2->getID() &&
+        entry.len1 == len1 && entry.len2 == len2)
+        return entry.result;
+
+    DGLLVMPointsToView pts1(n1->pointsTo);
+    DGLLVMPointsToView pts2(n2->pointsTo);
+    AliasResult result = AliasResult::NoAlias;
+    // fast path: the same pointer is in both sets
+    if (pts1.hasUnknown() || pts2.hasUnknown() ||
+        sharePointer(n1->pointsTo, n2->pointsTo) ||
+        pointsToSetsOverlap(pts1, len1, pts2, len2))
+        result = aliasOfOverlapping(pts1, pts2);
+
+    entry.id1 = n1->getID();
+    entry.id2 = n2->getID();
+    entry.len1 = len1;
+    entry.len2 = len2;
+    entry.result = result;
+
+    return result;
+}
+
+bool DGLLVMPointerAnalysis::runOnDemand(
+        const std::vector<const llvm::Value *> &vals) {
+    if (!PTA)
+        initialize();
+
+    if (_solved)
+        return true;
+
+    // only the flow-insensitive analysis can be solved on demand
+    if (!options.isFI() || options.threads || options.invalidateNodes ||
+        !options.loadResultsFrom.empty() || !options.saveResultsTo.empty())
+        return run();
+
+    if (!_demand)
+        _demand.reset(new pta::DemandDrivenPointerAnalysis(
+                *PTA, options.maxDemandedNodes));
+
+    std::vector<PSNode *> nodes;
+    nodes.reserve(vals.size());
+    for (const auto *val : vals) {
+        if (auto *node = getPointsToNode(val))
+            nodes.push_back(node);
+    }
+
+    _aliasCache.clear();
+    if (_demand->query(nodes))
+        return true;
+
+    llvm::errs() << "[PTA] demand-driven query exceeded the budget of "
+                 << options.maxDemandedNodes
+                 << " nodes, running the whole analysis\n";
+    // The demand-driven solver has processed nodes that the whole
+    // analysis may never reach and it has built subgraphs for calls
+    // via pointers, so start the whole analysis on a fresh graph.
+    // The analysis refers to the graph owned by the builder,
+    // so it must go first.
+    _demand.reset();
+    PTA.reset();
+    _builder.reset(new LLVMPointerGraphBuilder(_builder->getModule(), options));
+    PS = nullptr;
+    return run();
+}
+
 } // namespace dg
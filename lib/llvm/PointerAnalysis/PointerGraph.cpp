@@ -246,6 +246,48 @@ LLVMPointerGraphBuilder::createOrGetSubgraph(const llvm::Function *F) {
     return *it->second;
 }
 
+void LLVMPointerGraphBuilder::composeMapping(PointsToMapping<PSNode *> &&rhs) {
+    auto resolve = [&rhs](PSNode *nd) {
+        // the node may have been replaced by a node
+        // that was removed later too
+        while (PSNode *r = rhs.get(nd))
+            nd = r;
+        return nd;
+    };
+
+    for (auto &it : mapping)
+        it.second = resolve(it.second);
+
+    // the built sequences must not contain removed nodes,
+    // we use them to find operands when building new parts
+    // of the graph (e.g., for calls via function pointers)
+    for (auto &it : nodes_map) {
+        PSNodesSeq &seq = it.second;
+        PSNode *repr = resolve(seq.getRepresentant());
+        for (auto &nd : seq)
+            nd = resolve(nd);
+        seq.setRepresentant(repr);
+    }
+}
+
+std::vector<PSNode *> LLVMPointerGraphBuilder::getOpenNodes() const {
+    std::vector<PSNode *> nodes;
+    for (const auto &it : subgraphs_map) {
+        for (const auto &arg : it.first->args()) {
+            auto nit = nodes_map.find(&arg);
+            if (nit == nodes_map.end())
+                continue;
+            for (PSNode *nd : nit->second)
+                nodes.push_back(nd);
+        }
+
+        if (it.second->vararg)
+            nodes.push_back(it.second->vararg);
+    }
+
+    return nodes;
+}
+
 PointerSubgraph *LLVMPointerGraphBuilder::getSubgraph(const llvm::Function *F) {
     auto it = subgraphs_map.find(F);
     if (it == subgraphs_map.end()) {
@@ -638,7 +680,15 @@ PointerGraph *LLVMPointerGraphBuilder::buildLLVMPointerGraph() {
     // first we must build globals, because nodes can use them as operands
     buildGlobals();
 
-    // now we can build rest of the graph
+    // now we can build rest of the graph. NOTE: the functions are built
+    // one by one on purpose. Nodes get their ids and their points-to
+    // slots from PS when created, a call builds the called function
+    // in the middle of the caller (so the ids of the callee's nodes
+    // are interleaved with the caller's), and constant expressions
+    // and functions used as operands get one node that is shared
+    // via nodes_map by all the functions that use it. Building the
+    // functions in parallel would need nodes detached from PS and
+    // a linking pass replaying this order to get the same graph.
     PointerSubgraph &subg = buildFunction(*F);
     PSNode *root = subg.root;
     assert(root != nullptr);
@@ -0,0 +1,519 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "dg/llvm/PointerAnalysis/PointerAnalysis.h"
+
+#include "llvm/ValueIds.h"
+
+// The binary format of the stored results (all numbers are stored
+// in the native byte order):
+//
+//   header:  magic, version, hash of the module (see ModuleHasher),
+//            length and characters of the configuration of the analysis
+//   names:   number of names, then (length, characters) for each name
+//            of a global variable or function that is referred
+//   ptsets:  number of points-to sets, then for each set the value,
+//            the number of pointers and (target value, offset) pairs
+//   calls:   number of edges of the call graph, then (caller, callee)
+//            pairs of indices to names
+//
+// A value is stored as (kind, index of the name, index) where the
+// index is the index of the argument or of the instruction in the
+// function (or the id of the special node for special values).
+
+namespace dg {
+
+namespace {
+
+const char MAGIC[8] = {'D', 'G', 'P', 'T', 'A', 'R', 'E', 'S'};
+const uint32_t VERSION = 2;
+
+using llvmutils::ValueIds;
+using llvmutils::ValueKind;
+using llvmutils::ValueRef;
+using llvmutils::ValueResolver;
+
+// indices of special values
+enum : uint32_t { SPECIAL_NULL = 0, SPECIAL_UNKNOWN, SPECIAL_INVALIDATED };
+
+struct PointerRecord {
+    ValueRef target;
+    uint64_t offset;
+};
+
+struct PointsToRecord {
+    ValueRef value;
+    std::vector<PointerRecord> pointers;
+};
+
+// FNV-1a hash of the structure of a module. Types are identified
+// by their structure and local values by their position, so the hash
+// does not depend on their names (a module parsed again into the same
+// context gets renamed types, e.g., %struct.S.0).
+class ModuleHasher {
+    uint64_t hash{14695981039346656037ULL};
+    // the order in which we met the struct types
+    std::unordered_map<const llvm::Type *, uint64_t> structs;
+    // the positions of arguments, blocks and instructions
+    std::unordered_map<const llvm::Value *, uint64_t> locals;
+
+    void addBytes(const void *data, size_t size) {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    void add(uint64_t num) { addBytes(&num, sizeof(num)); }
+
+    void add(llvm::StringRef str) {
+        add(str.size());
+        addBytes(str.data(), str.size());
+    }
+
+    void add(const llvm::APInt &num) {
+        add(num.getBitWidth());
+        addBytes(num.getRawData(), num.getNumWords() * sizeof(uint64_t));
+    }
+
+    void add(const llvm::Type *Ty) {
+        add(Ty->getTypeID());
+        if (const auto *STy = llvm::dyn_cast<llvm::StructType>(Ty)) {
+            auto it = structs.find(STy);
+            if (it != structs.end()) {
+                add(it->second);
+                return;
+            }
+            add(structs.emplace(STy, structs.size()).first->second);
+            add(STy->isOpaque());
+            add(STy->isPacked());
+        } else if (const auto *ITy = llvm::dyn_cast<llvm::IntegerType>(Ty)) {
+            add(ITy->getBitWidth());
+        } else if (const auto *ATy = llvm::dyn_cast<llvm::ArrayType>(Ty)) {
+            add(ATy->getNumElements());
+        } else if (const auto *VTy = llvm::dyn_cast<llvm::VectorType>(Ty)) {
+            add(VTy->getElementCount().getKnownMinValue());
+        } else if (const auto *PTy = llvm::dyn_cast<llvm::PointerType>(Ty)) {
+            add(PTy->getAddressSpace());
+        } else if (const auto *FTy = llvm::dyn_cast<llvm::FunctionType>(Ty)) {
+            add(FTy->isVarArg());
+        }
+
+        add(Ty->getNumContainedTypes());
+        for (const auto *Sub : Ty->subtypes())
+            add(Sub);
+    }
+
+    void add(const llvm::Value *val) {
+        add(val->getValueID());
+        if (const auto *GV = llvm::dyn_cast<llvm::GlobalValue>(val)) {
+            add(GV->getName());
+            return;
+        }
+
+        auto it = locals.find(val);
+        if (it != locals.end()) {
+            add(it->second);
+            return;
+        }
+
+        add(val->getType());
+        if (const auto *CI = llvm::dyn_cast<llvm::ConstantInt>(val)) {
+            add(CI->getValue());
+        } else if (const auto *CF = llvm::dyn_cast<llvm::ConstantFP>(val)) {
+            add(CF->getValueAPF().bitcastToAPInt());
+        } else if (const auto *CD =
+                           llvm::dyn_cast<llvm::ConstantDataSequential>(
+                                   val)) {
+            add(CD->getRawDataValues());
+        } else if (const auto *CE = llvm::dyn_cast<llvm::ConstantExpr>(val)) {
+            add(CE->getOpcode());
+            if (CE->isCompare())
+                add(CE->getPredicate());
+            for (const auto &op : CE->operands())
+                add(op.get());
+        } else if (const auto *C = llvm::dyn_cast<llvm::ConstantAggregate>(
+                           val)) {
+            for (const auto &op : C->operands())
+                add(op.get());
+        } else if (const auto *IA = llvm::dyn_cast<llvm::InlineAsm>(val)) {
+            add(IA->getAsmString());
+            add(IA->getConstraintString());
+        }
+    }
+
+    void add(const llvm::Instruction &I) {
+        add(I.getOpcode());
+        add(I.getType());
+        if (const auto *CI = llvm::dyn_cast<llvm::CmpInst>(&I))
+            add(CI->getPredicate());
+        else if (const auto *AI = llvm::dyn_cast<llvm::AllocaInst>(&I))
+            add(AI->getAllocatedType());
+        else if (const auto *GEP = llvm::dyn_cast<llvm::GetElementPtrInst>(&I))
+            add(GEP->getSourceElementType());
+        else if (const auto *CB = llvm::dyn_cast<llvm::CallBase>(&I))
+            add(CB->getFunctionType());
+        else if (const auto *EV = llvm::dyn_cast<llvm::ExtractValueInst>(&I))
+            for (auto idx : EV->indices())
+                add(idx);
+        else if (const auto *IV = llvm::dyn_cast<llvm::InsertValueInst>(&I))
+            for (auto idx : IV->indices())
+                add(idx);
+
+        add(I.getNumOperands());
+        for (const auto &op : I.operands())
+            add(op.get());
+        if (const auto *PHI = llvm::dyn_cast<llvm::PHINode>(&I))
+            for (const auto *BB : PHI->blocks())
+                add(BB);
+    }
+
+    void add(const llvm::Function &F) {
+        add(F.getName());
+        add(F.getFunctionType());
+        add(F.isDeclaration());
+
+        locals.clear();
+        for (const auto &A : F.args())
+            locals.emplace(&A, locals.size());
+        for (const auto &B : F) {
+            locals.emplace(&B, locals.size());
+            for (const auto &I : B)
+                locals.emplace(&I, locals.size());
+        }
+
+        for (const auto &B : F) {
+            add(B.size());
+            for (const auto &I : B)
+                add(I);
+        }
+    }
+
+  public:
+    uint64_t get(const llvm::Module &M) {
+        for (const auto &G : M.globals()) {
+            add(G.getName());
+            add(G.getValueType());
+            add(G.isConstant());
+            add(G.hasInitializer());
+            if (G.hasInitializer())
+                add(G.getInitializer());
+        }
+        for (const auto &F : M)
+            add(F);
+        return hash;
+    }
+};
+
+uint64_t getModuleHash(const llvm::Module &M) { return ModuleHasher().get(M); }
+
+// all the options that change the results of the analysis
+std::string getConfiguration(const LLVMPointerAnalysisOptions &options) {
+    std::string ret;
+    llvm::raw_string_ostream os(ret);
+    os << "type=" << static_cast<unsigned>(options.analysisType)
+       << ";fs=" << *options.fieldSensitivity
+       << ";entry=" << options.entryFunction
+       << ";threads=" << options.threads
+       << ";invalidate=" << options.invalidateNodes
+       << ";geps=" << options.preprocessGeps
+       << ";merge=" << options.mergeEquivalentPointers
+       << ";offsets=" << options.maxObjectOffsets
+       << ";iterations=" << options.maxIterations
+       << ";timeout=" << options.timeout << ";memory=" << options.maxMemory;
+    for (const auto &it : options.allocationFunctions)
+        os << ";alloc:" << it.first << "=" << static_cast<unsigned>(it.second);
+    return os.str();
+}
+
+template <typename T>
+void write(std::ostream &out, const T &val) {
+    out.write(reinterpret_cast<const char *>(&val), sizeof(val));
+}
+
+void write(std::ostream &out, const ValueRef &ref) {
+    write(out, static_cast<uint8_t>(ref.kind));
+    write(out, ref.name);
+    write(out, ref.index);
+}
+
+template <typename T>
+bool read(std::istream &in, T &val) {
+    return static_cast<bool>(
+            in.read(reinterpret_cast<char *>(&val), sizeof(val)));
+}
+
+bool read(std::istream &in, ValueRef &ref) {
+    uint8_t kind;
+    if (!read(in, kind) || kind > static_cast<uint8_t>(ValueKind::INSTRUCTION))
+        return false;
+    ref.kind = static_cast<ValueKind>(kind);
+    return read(in, ref.name) && read(in, ref.index);
+}
+
+ValueRef getTargetRef(const ValueIds &ids, const pta::Pointer &ptr) {
+    if (ptr.isNull())
+        return {ValueKind::SPECIAL, 0, SPECIAL_NULL};
+    if (ptr.isInvalidated())
+        return {ValueKind::SPECIAL, 0, SPECIAL_INVALIDATED};
+
+    ValueRef ref;
+    const auto *val = ptr.target->getUserData<llvm::Value>();
+    if (ptr.isUnknown() || !val || !ids.get(val, ref))
+        return {ValueKind::SPECIAL, 0, SPECIAL_UNKNOWN};
+    return ref;
+}
+
+} // anonymous namespace
+
+bool DGLLVMPointerAnalysis::saveResults(const std::string &path) const {
+    const llvm::Module &M = *_builder->getModule();
+    ValueIds ids(M);
+
+    std::vector<PointsToRecord> records;
+    for (const auto &it : _builder->getNodesMap()) {
+        ValueRef ref;
+        if (!ids.get(it.first, ref))
+            continue;
+
+        PSNode *node = getPointsToNode(it.first);
+        if (!node || node->pointsTo.empty())
+            continue;
+
+        records.emplace_back();
+        records.back().value = ref;
+        auto &pointers = records.back().pointers;
+        pointers.reserve(node->pointsTo.size());
+        for (const auto &ptr : node->pointsTo)
+            pointers.push_back({getTargetRef(ids, ptr), *ptr.offset});
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> calls;
+    for (const auto &it : PS->getCallGraph()) {
+        ValueRef caller;
+        if (!ids.get(it.first->getUserData<llvm::Value>(), caller))
+            continue;
+        for (const auto *callee : it.second.getCalls()) {
+            ValueRef ref;
+            if (ids.get(callee->getValue()->getUserData<llvm::Value>(), ref))
+                calls.emplace_back(caller.name, ref.name);
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open())
+        return false;
+
+    out.write(MAGIC, sizeof(MAGIC));
+    write(out, VERSION);
+    write(out, getModuleHash(M));
+    auto config = getConfiguration(options);
+    write(out, static_cast<uint32_t>(config.size()));
+    out.write(config.data(), config.size());
+
+    write(out, static_cast<uint32_t>(ids.getNames().size()));
+    for (const auto &name : ids.getNames()) {
+        write(out, static_cast<uint32_t>(name.size()));
+        out.write(name.data(), name.size());
+    }
+
+    write(out, static_cast<uint32_t>(records.size()));
+    for (const auto &rec : records) {
+        write(out, rec.value);
+        write(out, static_cast<uint32_t>(rec.pointers.size()));
+        for (const auto &ptr : rec.pointers) {
+            write(out, ptr.target);
+            write(out, ptr.offset);
+        }
+    }
+
+    write(out, static_cast<uint32_t>(calls.size()));
+    for (const auto &edge : calls) {
+        write(out, edge.first);
+        write(out, edge.second);
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool DGLLVMPointerAnalysis::loadResults(const std::string &path) {
+    const llvm::Module &M = *_builder->getModule();
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version;
+    uint64_t hash;
+    uint32_t len;
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !read(in, version) || version != VERSION || !read(in, hash) ||
+        !read(in, len))
+        return false;
+
+    std::string config(len, '\0');
+    if (!in.read(&config[0], len))
+        return false;
+
+    if (config != getConfiguration(options)) {
+        llvm::errs() << "[PTA] the stored results are for a different "
+                        "configuration of the analysis\n";
+        return false;
+    }
+
+    if (hash != getModuleHash(M)) {
+        llvm::errs() << "[PTA] the stored results are for a different module\n";
+        return false;
+    }
+
+    // read everything before we touch the graph
+    uint32_t num;
+    if (!read(in, num))
+        return false;
+    std::vector<std::string> names(num);
+    for (auto &name : names) {
+        if (!read(in, len))
+            return false;
+        name.resize(len);
+        if (!in.read(&name[0], len))
+            return false;
+    }
+
+    if (!read(in, num))
+        return false;
+    std::vector<PointsToRecord> records(num);
+    for (auto &rec : records) {
+        if (!read(in, rec.value) || !read(in, num))
+            return false;
+        rec.pointers.resize(num);
+        for (auto &ptr : rec.pointers) {
+            if (!read(in, ptr.target) || !read(in, ptr.offset))
+                return false;
+        }
+    }
+
+    if (!read(in, num))
+        return false;
+    std::vector<std::pair<uint32_t, uint32_t>> calls(num);
+    for (auto &edge : calls) {
+        if (!read(in, edge.first) || !read(in, edge.second) ||
+            edge.first >= names.size() || edge.second >= names.size())
+            return false;
+    }
+
+    ValueResolver resolver(M, names);
+    std::vector<std::pair<const llvm::Value *, const PointsToRecord *>> pending;
+    pending.reserve(records.size());
+    for (const auto &rec : records) {
+        if (const auto *val = resolver.get(rec.value))
+            pending.emplace_back(val, &rec);
+    }
+
+    // allocation sites (the targets of pointers) by their values
+    std::unordered_map<const llvm::Value *, PSNode *> targets;
+    size_t visitedNodes = 0;
+    auto getTarget = [&](const ValueRef &ref) -> PSNode * {
+        if (ref.kind == ValueKind::SPECIAL) {
+            if (ref.index == SPECIAL_NULL)
+                return pta::NULLPTR;
+            if (ref.index == SPECIAL_INVALIDATED)
+                return pta::INVALIDATED;
+            return pta::UNKNOWN_MEMORY;
+        }
+        auto it = targets.find(resolver.get(ref));
+        return it == targets.end() ? pta::UNKNOWN_MEMORY : it->second;
+    };
+
+    // Fill the points-to sets. Calls via function pointers build
+    // new parts of the graph, so repeat until no new nodes appear
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        const auto &nodes = PS->getNodes();
+        for (; visitedNodes < nodes.size(); ++visitedNodes) {
+            PSNode *nd = nodes[visitedNodes].get();
+            if (!nd || (nd->getType() != pta::PSNodeType::ALLOC &&
+                        nd->getType() != pta::PSNodeType::FUNCTION))
+                continue;
+            if (const auto *val = nd->getUserData<llvm::Value>())
+                targets.emplace(val, nd);
+        }
+
+        std::vector<std::pair<const llvm::Value *, const PointsToRecord *>>
+                unresolved;
+        for (const auto &it : pending) {
+            // the node may be built later for a call via a pointer
+            PSNode *node = getPointsToNode(it.first);
+            if (!node) {
+                unresolved.push_back(it);
+                continue;
+            }
+            for (const auto &ptr : it.second->pointers)
+                node->addPointsTo(getTarget(ptr.target), ptr.offset);
+        }
+        pending.swap(unresolved);
+
+        // NOTE: the vector of nodes grows while we iterate over it
+        for (size_t i = 0; i < PS->getNodes().size(); ++i) {
+            PSNode *nd = PS->getNodes()[i].get();
+            if (!nd)
+                continue;
+
+            auto type = nd->getType();
+            if (type != pta::PSNodeType::CALL_FUNCPTR &&
+                type != pta::PSNodeType::FORK)
+                continue;
+
+            for (const auto &ptr : nd->getOperand(0)->pointsTo) {
+                if (ptr.target->getType() != pta::PSNodeType::FUNCTION ||
+                    !nd->addPointsTo(ptr))
+                    continue;
+
+                changed = true;
+                if (type == pta::PSNodeType::FORK)
+                    PTA->handleFork(nd, ptr.target);
+                else
+                    PTA->functionPointerCall(nd, ptr.target);
+            }
+        }
+
+        for (size_t i = 0; i < PS->getNodes().size(); ++i) {
+            PSNode *nd = PS->getNodes()[i].get();
+            if (nd && nd->getType() == pta::PSNodeType::JOIN)
+                changed |= PTA->handleJoin(nd);
+        }
+
+        if (PS->getNodes().size() > visitedNodes)
+            changed = true;
+    }
+
+    for (const auto &edge : calls) {
+        const auto *caller = M.getFunction(names[edge.first]);
+        const auto *callee = M.getFunction(names[edge.second]);
+        auto callerIt = targets.find(caller);
+        auto calleeIt = targets.find(callee);
+        if (callerIt != targets.end() && calleeIt != targets.end())
+            PS->registerCall(callerIt->second, calleeIt->second);
+    }
+
+    return true;
+}
+
+} // namespace dg
@@ -57,9 +57,22 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &os, const ValInfo &vi) {
 std::vector<DefSite>
 LLVMReadWriteGraphBuilder::mapPointers(const llvm::Value *where,
                                        const llvm::Value *val, Offset size) {
+    // query DG's points-to sets directly, without allocating the wrappers
+    if (!PTA->getOptions().isSVF()) {
+        auto *dgpta = static_cast<DGLLVMPointerAnalysis *>(PTA);
+        return mapPointers(where, val, size,
+                           dgpta->getLLVMPointsToViewChecked(val));
+    }
+
+    return mapPointers(where, val, size, PTA->getLLVMPointsToChecked(val));
+}
+
+template <typename PTSetT>
+std::vector<DefSite> LLVMReadWriteGraphBuilder::mapPointers(
+        const llvm::Value *where, const llvm::Value *val, Offset size,
+        const std::pair<bool, PTSetT> &psn) {
     std::vector<DefSite> result;
 
-    auto psn = PTA->getLLVMPointsToChecked(val);
     if (!psn.first) {
         result.emplace_back(UNKNOWN_MEMORY);
 #ifndef NDEBUG
@@ -88,6 +88,10 @@ class LLVMReadWriteGraphBuilder
 
     std::vector<DefSite> mapPointers(const llvm::Value *where,
                                      const llvm::Value *val, Offset size);
+    template <typename PTSetT>
+    std::vector<DefSite> mapPointers(const llvm::Value *where,
+                                     const llvm::Value *val, Offset size,
+                                     const std::pair<bool, PTSetT> &psn);
 
     RWNode *createStore(const llvm::Instruction *Inst);
     RWNode *createLoad(const llvm::Instruction *Inst);
@@ -0,0 +1,164 @@
+#include <string>
+#include <unordered_map>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#include "dg/SystemDependenceGraph/DGNodeCall.h"
+#include "dg/llvm/SystemDependenceGraph/SDG2Binary.h"
+#include "dg/llvm/SystemDependenceGraph/SystemDependenceGraph.h"
+
+#include "llvm/ValueIds.h"
+
+namespace dg {
+namespace llvmdg {
+
+namespace {
+
+using binary::EdgeKind;
+using binary::NodeKind;
+using llvmutils::ValueIds;
+using llvmutils::ValueRef;
+
+class SDGBinaryWriter {
+    SystemDependenceGraph &_llvmsdg;
+    const ValueIds &_ids;
+    binary::BinaryGraphWriter _writer;
+    std::unordered_map<sdg::DGNode *, uint32_t> _nodes;
+
+    // 'elem' is the element that is mapped to the LLVM value
+    // (the node itself or the pair of parameters)
+    void addNode(sdg::DGNode *node, const sdg::DGElement *elem, NodeKind kind,
+                 uint32_t owner) {
+        if (!node || _nodes.count(node) > 0)
+            return;
+
+        binary::NodeRecord rec;
+        rec.kind = kind;
+        rec.owner = owner;
+        ValueRef ref;
+        if (_ids.get(_llvmsdg.getValue(elem), ref)) {
+            // the numbering of kinds is the same
+            rec.valueKind = static_cast<binary::ValueKind>(ref.kind);
+            rec.name = ref.name;
+            rec.index = ref.index;
+        }
+        _nodes[node] = _writer.addNode(rec);
+    }
+
+    void addParameters(sdg::DGParameters &params, uint32_t owner) {
+        for (auto &param : params) {
+            addNode(&param.getInputArgument(), &param, NodeKind::PARAMETER_IN,
+                    owner);
+            addNode(&param.getOutputArgument(), &param,
+                    NodeKind::PARAMETER_OUT, owner);
+        }
+        addNode(params.getNoReturn(), params.getNoReturn(), NodeKind::NORETURN,
+                owner);
+        addNode(params.getReturn(), params.getReturn(), NodeKind::RETURN,
+                owner);
+    }
+
+    void addFunction(const llvm::Function &F, sdg::DependenceGraph *dg) {
+        ValueRef ref;
+        auto fun = _writer.addFunction(_ids.get(&F, ref) ? ref.name
+                                                         : binary::NONE);
+        addParameters(dg->getParameters(), binary::NONE);
+        for (auto *nd : dg->getNodes()) {
+            addNode(nd, nd, NodeKind::VALUE, binary::NONE);
+            if (auto *C = sdg::DGNodeCall::get(nd))
+                addParameters(C->getParameters(), _nodes[nd]);
+        }
+
+        auto it = _nodes.find(dg->getFirstNode());
+        if (it != _nodes.end())
+            _writer.setEntry(fun, it->second);
+    }
+
+    // add the edge, the edges from a block go from its terminator
+    // and the edges to a block go to all nodes of the block
+    void addEdge(EdgeKind kind, sdg::DGElement *src, sdg::DGElement *dst) {
+        if (auto *B = sdg::DGBBlock::get(src)) {
+            if (B->getNodes().empty())
+                return;
+            src = B->back();
+        }
+
+        auto srcIt = _nodes.find(sdg::DGNode::get(src));
+        if (srcIt == _nodes.end())
+            return;
+
+        if (auto *B = sdg::DGBBlock::get(dst)) {
+            for (auto *nd : B->getNodes())
+                addEdge(kind, src, nd);
+            return;
+        }
+
+        auto dstIt = _nodes.find(sdg::DGNode::get(dst));
+        if (dstIt != _nodes.end())
+            _writer.addEdge(kind, srcIt->second, dstIt->second);
+    }
+
+    void addEdges(sdg::DGNode *nd) {
+        // the nodes that use the value of 'nd'
+        for (auto *use : nd->uses())
+            addEdge(EdgeKind::USE, nd, use);
+        for (auto *def : nd->memdep())
+            addEdge(EdgeKind::DATA, def, nd);
+        for (auto *ctrl : nd->controls())
+            addEdge(EdgeKind::CONTROL, nd, ctrl);
+
+        if (auto *A = sdg::DGNodeArgument::get(nd)) {
+            for (auto *param : A->parameter_in())
+                addEdge(EdgeKind::PARAMETER, nd, param);
+            for (auto *param : A->parameter_out())
+                addEdge(EdgeKind::PARAMETER, nd, param);
+        }
+
+        if (auto *C = sdg::DGNodeCall::get(nd)) {
+            for (auto *dg : C->getCallees()) {
+                if (auto *entry = dg->getFirstNode())
+                    addEdge(EdgeKind::CALL, nd, entry);
+            }
+        }
+    }
+
+  public:
+    SDGBinaryWriter(SystemDependenceGraph &sdg, const ValueIds &ids)
+            : _llvmsdg(sdg), _ids(ids) {}
+
+    bool write(const llvm::Module &M, const std::string &path) {
+        for (const auto &F : M) {
+            if (auto *dg = _llvmsdg.getDG(&F))
+                addFunction(F, dg);
+        }
+
+        for (const auto &F : M) {
+            auto *dg = _llvmsdg.getDG(&F);
+            if (!dg)
+                continue;
+
+            for (auto *blk : dg->getBBlocks()) {
+                for (auto *ctrl : blk->controls())
+                    addEdge(EdgeKind::CONTROL, blk, ctrl);
+            }
+        }
+
+        for (const auto &it : _nodes)
+            addEdges(it.first);
+
+        _writer.setNames(_ids.getNames());
+        return _writer.write(path);
+    }
+};
+
+} // anonymous namespace
+
+bool writeBinaryGraph(SystemDependenceGraph &sdg, const std::string &path) {
+    const auto *M = sdg.getModule();
+    ValueIds ids(*M);
+    return SDGBinaryWriter(sdg, ids).write(*M, path);
+}
+
+} // namespace llvmdg
+} // namespace dg
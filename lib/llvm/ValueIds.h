@@ -0,0 +1,128 @@
+#ifndef DG_LLVM_VALUE_IDS_H_
+#define DG_LLVM_VALUE_IDS_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Module.h>
+
+namespace dg {
+namespace llvmutils {
+
+// the numbers are stored in files, do not change them
+enum class ValueKind : uint8_t {
+    SPECIAL = 0, // a value that has no identifier (e.g., a constant)
+    GLOBAL = 1,
+    FUNCTION = 2,
+    ARGUMENT = 3,
+    INSTRUCTION = 4
+};
+
+struct ValueRef {
+    ValueKind kind{ValueKind::SPECIAL};
+    uint32_t name{0};
+    uint32_t index{0};
+};
+
+///
+// Stable identifiers of LLVM values (the name of the global
+// or function and the index of the argument or instruction)
+class ValueIds {
+    std::vector<std::string> _names;
+    std::unordered_map<std::string, uint32_t> _nameIds;
+    std::unordered_map<const llvm::Value *, ValueRef> _ids;
+
+  public:
+    uint32_t getNameId(llvm::StringRef name) {
+        auto it = _nameIds.emplace(name.str(), _names.size());
+        if (it.second)
+            _names.push_back(name.str());
+        return it.first->second;
+    }
+
+    ValueIds(const llvm::Module &M) {
+        for (const auto &G : M.globals()) {
+            if (G.hasName())
+                _ids[&G] = {ValueKind::GLOBAL, getNameId(G.getName()), 0};
+        }
+
+        for (const auto &F : M) {
+            if (!F.hasName())
+                continue;
+
+            uint32_t name = getNameId(F.getName());
+            _ids[&F] = {ValueKind::FUNCTION, name, 0};
+            uint32_t idx = 0;
+            for (const auto &A : F.args())
+                _ids[&A] = {ValueKind::ARGUMENT, name, idx++};
+
+            idx = 0;
+            for (const auto &I : llvm::instructions(F))
+                _ids[&I] = {ValueKind::INSTRUCTION, name, idx++};
+        }
+    }
+
+    bool get(const llvm::Value *val, ValueRef &ref) const {
+        auto it = _ids.find(val);
+        if (it == _ids.end())
+            return false;
+        ref = it->second;
+        return true;
+    }
+
+    const std::vector<std::string> &getNames() const { return _names; }
+};
+
+///
+// Mapping of stable identifiers back to the LLVM values
+class ValueResolver {
+    const llvm::Module &M;
+    const std::vector<std::string> &names;
+    std::unordered_map<const llvm::Function *,
+                       std::vector<const llvm::Instruction *>>
+            instructions;
+
+  public:
+    ValueResolver(const llvm::Module &M, const std::vector<std::string> &n)
+            : M(M), names(n) {}
+
+    const llvm::Value *get(const ValueRef &ref) {
+        if (ref.kind == ValueKind::SPECIAL || ref.name >= names.size())
+            return nullptr;
+
+        if (ref.kind == ValueKind::GLOBAL)
+            return M.getGlobalVariable(names[ref.name], true);
+
+        const auto *F = M.getFunction(names[ref.name]);
+        if (!F || ref.kind == ValueKind::FUNCTION)
+            return F;
+
+        if (ref.kind == ValueKind::ARGUMENT) {
+            if (ref.index >= F->arg_size())
+                return nullptr;
+            return F->arg_begin() + ref.index;
+        }
+
+        auto it = instructions.find(F);
+        if (it == instructions.end()) {
+            auto &insts = instructions[F];
+            for (const auto &I : llvm::instructions(*F))
+                insts.push_back(&I);
+            it = instructions.find(F);
+        }
+
+        if (ref.index >= it->second.size())
+            return nullptr;
+        return it->second[ref.index];
+    }
+};
+
+} // namespace llvmutils
+} // namespace dg
+
+#endif // DG_LLVM_VALUE_IDS_H_
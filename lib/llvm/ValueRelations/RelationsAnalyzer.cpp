@@ -1300,6 +1300,8 @@ bool RelationsAnalyzer::passFunction(const llvm::Function &function,
         } // else no predecessors => nothing to be passed
 
         bool locationChanged = location.relations.unsetChanged();
+        if (locationChanged)
+            locationChanged = checkBudget(location);
 #ifndef NDEBUG
         if (print && cond) {
             std::cerr << "after\n";
@@ -1313,8 +1315,8 @@ bool RelationsAnalyzer::passFunction(const llvm::Function &function,
     return changed;
 }
 
-unsigned RelationsAnalyzer::analyze(unsigned maxPass) {
-    unsigned maxExecutedPass = 0;
+unsigned RelationsAnalyzer::analyze() {
+    startTime = Clock::now();
 
     for (const auto &function : module) {
         if (function.isDeclaration())
@@ -1322,15 +1324,124 @@ unsigned RelationsAnalyzer::analyze(unsigned maxPass) {
 
         bool changed = true;
         unsigned passNum = 0;
-        while (changed && passNum < maxPass) {
+        while (changed && passNum < options.maxPass && !stats.timedOut) {
             changed = passFunction(function, false); // passNum + 1 == maxPass);
             ++passNum;
+            stats.timedOut = isOutOfTime();
         }
 
-        maxExecutedPass = std::max(maxExecutedPass, passNum);
+        if (changed)
+            ++stats.unfinishedFunctions;
+        stats.maxExecutedPass = std::max(stats.maxExecutedPass, passNum);
+    }
+
+    return stats.maxExecutedPass;
+}
+
+unsigned RelationsAnalyzer::analyze(unsigned maxPass) {
+    options.maxPass = maxPass;
+    return analyze();
+}
+
+// ***************************** budget ****************************** //
+bool RelationsAnalyzer::isLoopHeader(const VRLocation &location) {
+    for (const VREdge *predEdge : location.predecessors) {
+        if (predEdge->type == EdgeType::BACK)
+            return true;
+    }
+    return false;
+}
+
+RelationsAnalyzer::Signature
+RelationsAnalyzer::getSignature(const ValueRelations &relations) {
+    Signature result;
+    for (const auto &bucketVals : relations.getBucketToVals()) {
+        std::pair<size_t, size_t> sig(
+                bucketVals.second.size(),
+                relations.getRelated(bucketVals.first, comparative).size());
+        for (V val : bucketVals.second)
+            result.emplace(val, sig);
+    }
+    return result;
+}
+
+void RelationsAnalyzer::addUnstable(const Signature &last,
+                                    const Signature &current,
+                                    std::set<V> &unstable, bool missing) {
+    for (const auto &valSig : current) {
+        auto it = last.find(valSig.first);
+        if (it == last.end() ? missing : it->second != valSig.second)
+            unstable.insert(valSig.first);
+    }
+}
+
+// Drop the relations of the values that changed while iterating the loop
+// (or appeared after that), dropping them may change the relations of other
+// values, so repeat until no new value changes. Returns true if the relations
+// differ from the last iteration.
+bool RelationsAnalyzer::widen(ValueRelations &relations, LoopBudget &budget) {
+    Signature current;
+    size_t unstable;
+    do {
+        unstable = budget.unstable.size();
+        for (V val : budget.unstable)
+            relations.unsetComparativeRelations(val);
+        current = getSignature(relations);
+        addUnstable(budget.last, current, budget.unstable, true);
+    } while (budget.unstable.size() != unstable);
+    relations.unsetChanged();
+
+    bool changed = current != budget.last;
+    budget.last = std::move(current);
+    return changed;
+}
+
+// Returns true if the relations at the location changed
+// after applying the budgets
+bool RelationsAnalyzer::checkBudget(VRLocation &location) {
+    ValueRelations &relations = location.relations;
+    if (forgotten.find(&location) != forgotten.end()) {
+        relations.clear();
+        relations.unsetChanged();
+        return false;
+    }
+
+    if (options.maxBuckets > 0 &&
+        relations.getBucketToVals().size() > options.maxBuckets) {
+        // keeping just a part of the relations would not be sound,
+        // the location may lack relations that invalidate the rest
+        relations.clear();
+        relations.unsetChanged();
+        forgotten.emplace(&location);
+        ++stats.overBudgetLocations;
+        return true;
+    }
+
+    if (options.maxLoopIterations == 0 || !isLoopHeader(location))
+        return true;
+
+    LoopBudget &budget = loopBudgets[&location];
+    ++budget.changes;
+    if (budget.changes <= options.maxLoopIterations) {
+        Signature current = getSignature(relations);
+        if (budget.changes > 1)
+            addUnstable(budget.last, current, budget.unstable, false);
+        budget.last = std::move(current);
+        return true;
     }
 
-    return maxExecutedPass;
+    if (!budget.widened) {
+        budget.widened = true;
+        ++stats.widenedLocations;
+    }
+    return widen(relations, budget);
+}
+
+bool RelationsAnalyzer::isOutOfTime() const {
+    if (options.timeout == 0)
+        return false;
+    return Clock::now() - startTime >=
+           std::chrono::milliseconds(options.timeout);
 }
 
 std::vector<V> RelationsAnalyzer::getFroms(const ValueRelations &rels, V val) {
@@ -279,6 +279,9 @@ StructureAnalyzer::collectBackward(const llvm::Function &f, VRLocation &from) {
 }
 
 void StructureAnalyzer::initializeDefined() {
+    // prepare sets of defined values for each location
+    defined.assign(codeGraph.size(), std::set<const llvm::Value *>());
+
     for (const llvm::Function &function : module) {
         if (function.isDeclaration())
             continue;
@@ -286,11 +289,6 @@ void StructureAnalyzer::initializeDefined() {
         std::list<VRLocation *> toVisit = {
                 &codeGraph.getEntryLocation(function)};
 
-        // prepare sets of defined values for each location
-        for (auto &location : codeGraph) {
-            defined.emplace(&location, std::set<const llvm::Value *>());
-        }
-
         while (!toVisit.empty()) {
             VRLocation *current = toVisit.front();
             toVisit.pop_front();
@@ -308,8 +306,8 @@ void StructureAnalyzer::initializeDefined() {
                 if (succEdge->type == EdgeType::BACK)
                     continue;
 
-                auto &definedSucc = defined.at(succLoc);
-                auto &definedHere = defined.at(current);
+                auto &definedSucc = defined[succLoc->id];
+                auto &definedHere = defined[current->id];
 
                 // copy from this location to its successor
                 definedSucc.insert(definedHere.begin(), definedHere.end());
@@ -377,11 +375,20 @@ void StructureAnalyzer::collectAllocatedAreas() {
             }
         }
     }
+
+    heapAreas = ValidAreas(allocatedAreas.size(), false);
+    unsigned index = 0;
+    for (const AllocatedArea &area : allocatedAreas) {
+        areaIndices.emplace(area.getPtr(), index);
+        if (llvm::isa<llvm::CallInst>(area.getPtr()))
+            heapAreas.set(index);
+        ++index;
+    }
 }
 
 void StructureAnalyzer::setValidAreasFromNoPredecessors(
-        std::vector<bool> &validAreas) const {
-    validAreas = std::vector<bool>(allocatedAreas.size(), false);
+        ValidAreas &validAreas) const {
+    validAreas = ValidAreas(allocatedAreas.size(), false);
 }
 
 std::pair<unsigned, const AllocatedArea *>
@@ -398,17 +405,12 @@ StructureAnalyzer::getEqualArea(const ValueRelations &graph,
 }
 
 void StructureAnalyzer::invalidateHeapAllocatedAreas(
-        std::vector<bool> &validAreas) const {
-    unsigned index = 0;
-    for (const AllocatedArea &area : allocatedAreas) {
-        if (llvm::isa<llvm::CallInst>(area.getPtr()))
-            validAreas[index] = false;
-        ++index;
-    }
+        ValidAreas &validAreas) const {
+    validAreas.subtract(heapAreas);
 }
 
 void StructureAnalyzer::setValidAreasByInstruction(
-        VRLocation &location, std::vector<bool> &validAreas,
+        VRLocation &location, ValidAreas &validAreas,
         VRInstruction *vrinst) const {
     const llvm::Instruction *inst = vrinst->getInstruction();
     unsigned index = 0;
@@ -418,7 +420,7 @@ void StructureAnalyzer::setValidAreasByInstruction(
     if (llvm::isa<llvm::AllocaInst>(inst)) {
         std::tie(index, area) = getAllocatedAreaFor(inst);
         assert(area);
-        validAreas[index] = true;
+        validAreas.set(index);
     }
 
     // if came across lifetime_end call, then mark memory whose scope ended
@@ -428,7 +430,7 @@ void StructureAnalyzer::setValidAreasByInstruction(
             std::tie(index, area) =
                     getEqualArea(location.relations, intrinsic->getOperand(1));
             assert(area);
-            validAreas[index] = false;
+            validAreas.reset(index);
         }
     }
 
@@ -446,7 +448,7 @@ void StructureAnalyzer::setValidAreasByInstruction(
             std::tie(index, area) =
                     getEqualArea(location.relations, call->getOperand(0));
             if (area)
-                validAreas[index] = false;
+                validAreas.reset(index);
             else if (!llvm::isa<llvm::ConstantPointerNull>(
                              call->getOperand(0))) {
                 // else we do not know which area has been reallocated and
@@ -463,7 +465,7 @@ void StructureAnalyzer::setValidAreasByInstruction(
                     getEqualArea(location.relations, call->getOperand(0));
 
             if (area)
-                validAreas[index] = false;
+                validAreas.reset(index);
             else if (!llvm::isa<llvm::ConstantPointerNull>(
                              call->getOperand(0))) {
                 // else we do not know which area has been freed, so it may
@@ -474,7 +476,7 @@ void StructureAnalyzer::setValidAreasByInstruction(
     }
 }
 
-void StructureAnalyzer::setValidArea(std::vector<bool> &validAreas,
+void StructureAnalyzer::setValidArea(ValidAreas &validAreas,
                                      const AllocatedArea *area, unsigned index,
                                      bool validateThis) const {
     unsigned preReallocIndex = 0;
@@ -484,20 +486,20 @@ void StructureAnalyzer::setValidArea(std::vector<bool> &validAreas,
                 getAllocatedAreaFor(area->getReallocatedPtr());
 
     if (validateThis) {
-        validAreas[index] = true;
+        validAreas.set(index);
         if (preReallocArea)
             assert(!validAreas[preReallocIndex]);
 
         // else the original area, if any, should be validated
     } else if (preReallocArea) {
-        validAreas[preReallocIndex] = true;
+        validAreas.set(preReallocIndex);
         assert(!validAreas[index]);
     }
 }
 
 // if heap allocation call was just checked as successful, mark memory valid
 void StructureAnalyzer::setValidAreasByAssumeBool(VRLocation &location,
-                                                  std::vector<bool> &validAreas,
+                                                  ValidAreas &validAreas,
                                                   VRAssumeBool *assume) const {
     const auto *icmp = llvm::dyn_cast<llvm::ICmpInst>(assume->getValue());
     if (!icmp)
@@ -578,10 +580,12 @@ void StructureAnalyzer::setValidAreasByAssumeBool(VRLocation &location,
 }
 
 void StructureAnalyzer::setValidAreasFromSinglePredecessor(
-        VRLocation &location, std::vector<bool> &validAreas) const {
+        VRLocation &location, ValidAreas &validAreas) const {
     // copy predecessors valid areas
     VREdge *edge = location.getPredEdge(0);
-    validAreas = edge->source->relations.getValidAreas();
+    validAreas = validAreasByLocation[edge->source->id];
+    if (validAreas.empty())
+        setValidAreasFromNoPredecessors(validAreas);
 
     // and alter them according to info from edge
     if (edge->op->isInstruction())
@@ -594,20 +598,11 @@ void StructureAnalyzer::setValidAreasFromSinglePredecessor(
                                   static_cast<VRAssumeBool *>(edge->op.get()));
 }
 
-bool StructureAnalyzer::trueInAll(
-        const std::vector<std::vector<bool>> &validInPreds, unsigned index) {
-    for (const auto &validInPred : validInPreds) {
-        if (validInPred.empty() || !validInPred[index])
-            return false;
-    }
-    return true;
-}
-
-// in returned vector, false signifies that corresponding area is
+// in returned set, unset bit signifies that corresponding area is
 // invalidated by some of the passed instructions
-std::vector<bool> StructureAnalyzer::getInvalidatedAreas(
+ValidAreas StructureAnalyzer::getInvalidatedAreas(
         const std::vector<const llvm::Instruction *> &instructions) const {
-    std::vector<bool> validAreas(allocatedAreas.size(), true);
+    ValidAreas validAreas(allocatedAreas.size(), true);
 
     for (const llvm::Instruction *inst : instructions) {
         VRLocation &location = codeGraph.getVRLocation(inst);
@@ -619,37 +614,52 @@ std::vector<bool> StructureAnalyzer::getInvalidatedAreas(
 }
 
 void StructureAnalyzer::setValidAreasFromMultiplePredecessors(
-        VRLocation &location, std::vector<bool> &validAreas) const {
-    std::vector<std::vector<bool>> validInPreds;
-
+        VRLocation &location, ValidAreas &validAreas) const {
     if (!location.isJustLoopJoin()) {
-        for (VREdge *predEdge : location.predecessors)
-            validInPreds.emplace_back(
-                    predEdge->source->relations.getValidAreas());
-    } else {
-        VRLocation *treePred = nullptr;
+        bool first = true;
         for (VREdge *predEdge : location.predecessors) {
-            if (predEdge->type == EdgeType::TREE) {
-                treePred = predEdge->source;
-                break;
+            const ValidAreas &inPred =
+                    validAreasByLocation[predEdge->source->id];
+            // predecessor not computed yet, nothing can be considered valid
+            if (inPred.empty()) {
+                setValidAreasFromNoPredecessors(validAreas);
+                return;
             }
+
+            if (first)
+                validAreas = inPred;
+            else
+                validAreas.intersect(inPred);
+            first = false;
         }
-        assert(treePred);
+        return;
+    }
 
-        validInPreds.emplace_back(treePred->relations.getValidAreas());
-        validInPreds.emplace_back(
-                getInvalidatedAreas(inloopValues.at(&location)));
+    VRLocation *treePred = nullptr;
+    for (VREdge *predEdge : location.predecessors) {
+        if (predEdge->type == EdgeType::TREE) {
+            treePred = predEdge->source;
+            break;
+        }
     }
+    assert(treePred);
 
-    // intersect valid areas from predecessors
-    for (unsigned i = 0; i < allocatedAreas.size(); ++i) {
-        validAreas.push_back(trueInAll(validInPreds, i));
+    const ValidAreas &inTreePred = validAreasByLocation[treePred->id];
+    if (inTreePred.empty()) {
+        setValidAreasFromNoPredecessors(validAreas);
+        return;
     }
+
+    // whatever is invalidated anywhere in the loop is not valid at its start
+    validAreas = inTreePred;
+    validAreas.intersect(getInvalidatedAreas(inloopValues.at(&location)));
 }
 
-void StructureAnalyzer::computeValidAreas() const {
-    for (auto &location : codeGraph) {
-        std::vector<bool> &validAreas = location.relations.getValidAreas();
+void StructureAnalyzer::computeValidAreas(const llvm::Function &function) {
+    for (auto it = codeGraph.lazy_dfs_begin(function);
+         it != codeGraph.lazy_dfs_end(); ++it) {
+        VRLocation &location = *it;
+        ValidAreas &validAreas = validAreasByLocation[location.id];
 
         switch (location.predsSize()) {
         case 0:
@@ -665,6 +675,16 @@ void StructureAnalyzer::computeValidAreas() const {
     }
 }
 
+void StructureAnalyzer::computeValidAreas() {
+    validAreasByLocation.assign(codeGraph.size(), ValidAreas());
+
+    for (const llvm::Function &function : module) {
+        if (function.isDeclaration())
+            continue;
+        computeValidAreas(function);
+    }
+}
+
 void StructureAnalyzer::initializeCallRelations() {
     for (const llvm::Function &function : module) {
         if (function.isDeclaration())
@@ -720,7 +740,8 @@ bool StructureAnalyzer::isDefined(VRLocation *loc,
     if (llvm::isa<llvm::Constant>(val))
         return true;
 
-    auto definedHere = defined.at(loc);
+    assert(loc->id < defined.size());
+    const auto &definedHere = defined[loc->id];
     return definedHere.find(val) != definedHere.end();
 }
 
@@ -777,13 +798,10 @@ StructureAnalyzer::getRelevantConditions(const VRAssumeBool *assume) const {
 
 std::pair<unsigned, const AllocatedArea *>
 StructureAnalyzer::getAllocatedAreaFor(const llvm::Value *ptr) const {
-    unsigned i = 0;
-    for (const auto &area : allocatedAreas) {
-        if (area.getPtr() == ptr)
-            return {i, &area};
-        ++i;
-    }
-    return {0, nullptr};
+    auto it = areaIndices.find(ptr);
+    if (it == areaIndices.end())
+        return {0, nullptr};
+    return {it->second, &allocatedAreas[it->second]};
 }
 
 const std::vector<CallRelation> &
@@ -271,6 +271,28 @@ bool ValueRelations::holdsAnyRelations() const {
     return !valToBucket.empty() && !graph.empty();
 }
 
+void ValueRelations::clear() {
+    std::vector<BRef> erased;
+    for (auto &bucketVals : bucketToVals) {
+        if (graph.getBorderId(bucketVals.first) == std::string::npos) {
+            erased.emplace_back(bucketVals.first);
+            continue;
+        }
+
+        for (V val : bucketVals.second)
+            valToBucket.erase(val);
+        updateChanged(!bucketVals.second.empty());
+        bucketVals.second.clear();
+        updateChanged(graph.unset(bucketVals.first,
+                                  Relations(allRelations)
+                                          .set(Relations::EQ, false)));
+    }
+
+    for (Handle h : erased)
+        erasePlaceholderBucket(h);
+    updateChanged(!erased.empty());
+}
+
 ValueRelations::HandlePtr
 ValueRelations::getCorresponding(const ValueRelations &other, Handle otherH,
                                  const VectorSet<V> &otherEqual) {
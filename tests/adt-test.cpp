@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 
+#include "dg/ADT/Arena.h"
 #include "dg/ADT/Bitvector.h"
 #include "dg/ADT/Queue.h"
 #include "dg/ReadWriteGraph/DefSite.h"
@@ -67,6 +68,46 @@ TEST_CASE("Priority queue basic manimp", "Priority Queue") {
     REQUIRE(queue.empty());
 }
 
+TEST_CASE("Arena allocation", "Arena") {
+    Arena A(64);
+    std::vector<uint64_t *> objs;
+    for (uint64_t i = 0; i < 100; ++i) {
+        auto *x = A.create<uint64_t>(i);
+        REQUIRE(reinterpret_cast<uintptr_t>(x) % alignof(uint64_t) == 0);
+        objs.push_back(x);
+    }
+
+    // the objects did not overwrite each other
+    for (uint64_t i = 0; i < 100; ++i)
+        REQUIRE(*objs[i] == i);
+
+    // an object that does not fit into a chunk
+    auto *big = static_cast<char *>(A.allocate(1000));
+    big[999] = 'x';
+    REQUIRE(big[999] == 'x');
+    REQUIRE(*objs[99] == 99);
+    REQUIRE(A.chunksNum() > 1);
+}
+
+TEST_CASE("Chunked array", "Arena") {
+    ChunkedArray<uint64_t, 8> arr;
+    REQUIRE(arr.empty());
+
+    std::vector<uint64_t *> objs;
+    for (uint64_t i = 0; i < 100; ++i)
+        objs.push_back(&arr.emplace_back(i));
+
+    REQUIRE(arr.size() == 100);
+    // the objects did not move while the array grew
+    for (uint64_t i = 0; i < 100; ++i) {
+        REQUIRE(objs[i] == &arr[i]);
+        REQUIRE(arr[i] == i);
+    }
+
+    // the objects in one chunk are next to each other
+    REQUIRE(&arr[7] == &arr[0] + 7);
+}
+
 TEST_CASE("Intervals handling", "RWG intervals") {
     using namespace dg::dda;
 
@@ -0,0 +1,158 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "dg/BinaryGraph.h"
+
+using namespace dg::binary;
+
+static std::string tmpFile() {
+    char name[] = "/tmp/dg-binary-graph-XXXXXX";
+    int fd = mkstemp(name);
+    REQUIRE(fd >= 0);
+    // the file is written by the path
+    ::close(fd);
+    return name;
+}
+
+static std::vector<uint32_t> toVector(const BinaryGraph::edges_range &R) {
+    return {R.begin(), R.end()};
+}
+
+TEST_CASE("Write and read a graph", "BinaryGraph") {
+    BinaryGraphWriter writer;
+    writer.setNames({"g", "main", "foo"});
+
+    NodeRecord glob;
+    glob.valueKind = ValueKind::GLOBAL;
+    glob.name = 0;
+    auto g = writer.addNode(glob);
+
+    auto main = writer.addFunction(1);
+    NodeRecord inst;
+    inst.valueKind = ValueKind::INSTRUCTION;
+    inst.name = 1;
+    auto m0 = writer.addNode(inst);
+    inst.index = 1;
+    auto m1 = writer.addNode(inst);
+    NodeRecord param;
+    param.kind = NodeKind::PARAMETER_IN;
+    param.owner = m1;
+    auto m2 = writer.addNode(param);
+    writer.setEntry(main, m0);
+
+    auto foo = writer.addFunction(2);
+    NodeRecord art;
+    art.kind = NodeKind::ARTIFICIAL;
+    auto f0 = writer.addNode(art);
+    writer.setEntry(foo, f0);
+
+    writer.addEdge(EdgeKind::USE, g, m1);
+    writer.addEdge(EdgeKind::USE, m0, m1);
+    writer.addEdge(EdgeKind::CONTROL, m0, m2);
+    writer.addEdge(EdgeKind::CALL, m1, f0);
+    // duplicate edges are stored only once
+    writer.addEdge(EdgeKind::DATA, f0, g);
+    writer.addEdge(EdgeKind::DATA, f0, g);
+
+    auto path = tmpFile();
+    REQUIRE(writer.write(path));
+
+    BinaryGraph G;
+    REQUIRE(G.open(path));
+    REQUIRE(G.getNumNames() == 3);
+    REQUIRE(G.getNumFunctions() == 2);
+    REQUIRE(G.getNumNodes() == 5);
+
+    REQUIRE(std::string(G.getName(G.getFunction(main).name)) == "main");
+    REQUIRE(G.findFunction("foo") == foo);
+    REQUIRE(G.findFunction("bar") == NONE);
+    REQUIRE(G.getFunction(main).firstNode == m0);
+    REQUIRE(G.getFunction(main).numNodes == 3);
+    REQUIRE(G.getFunction(main).entry == m0);
+    REQUIRE(G.getFunction(foo).firstNode == f0);
+    REQUIRE(G.getFunction(foo).numNodes == 1);
+
+    REQUIRE(G.getNode(g).function == NONE);
+    REQUIRE(G.getNode(g).valueKind == ValueKind::GLOBAL);
+    REQUIRE(G.getNode(m1).function == main);
+    REQUIRE(G.getNode(m1).index == 1);
+    REQUIRE(G.getNode(m2).kind == NodeKind::PARAMETER_IN);
+    REQUIRE(G.getNode(m2).owner == m1);
+    REQUIRE(G.getNode(f0).function == foo);
+
+    REQUIRE(toVector(G.getPredecessors(EdgeKind::USE, m1)) ==
+            std::vector<uint32_t>{g, m0});
+    REQUIRE(toVector(G.getSuccessors(EdgeKind::USE, g)) ==
+            std::vector<uint32_t>{m1});
+    REQUIRE(toVector(G.getSuccessors(EdgeKind::CONTROL, m0)) ==
+            std::vector<uint32_t>{m2});
+    REQUIRE(toVector(G.getPredecessors(EdgeKind::CALL, f0)) ==
+            std::vector<uint32_t>{m1});
+    REQUIRE(G.getSuccessors(EdgeKind::INTERFERENCE, m0).empty());
+    REQUIRE(G.getNumEdges(EdgeKind::DATA) == 1);
+    REQUIRE(G.getNumEdges(EdgeKind::USE) == 2);
+
+    G.close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Reject invalid files", "BinaryGraph") {
+    BinaryGraphWriter writer;
+    writer.setNames({"main"});
+    writer.addFunction(0);
+    auto n0 = writer.addNode({});
+    auto n1 = writer.addNode({});
+    writer.addEdge(EdgeKind::DATA, n0, n1);
+
+    auto path = tmpFile();
+    REQUIRE(writer.write(path));
+
+    std::string data;
+    {
+        std::ifstream in(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in),
+                    std::istreambuf_iterator<char>());
+    }
+
+    BinaryGraph G;
+    REQUIRE(G.open(path));
+    G.close();
+
+    auto writeData = [&path](const std::string &d) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(d.data(), d.size());
+    };
+
+    SECTION("truncated file") {
+        writeData(data.substr(0, data.size() - 8));
+        REQUIRE(!G.open(path));
+    }
+
+    SECTION("wrong magic") {
+        auto bad = data;
+        bad[0] = 'X';
+        writeData(bad);
+        REQUIRE(!G.open(path));
+    }
+
+    SECTION("target out of bounds") {
+        // the last edges section ends with the target of the only edge
+        // of the reverse data dependencies, but it is followed
+        // by other sections, so corrupt the whole tail
+        auto bad = data;
+        for (size_t i = bad.size() - 64; i < bad.size(); ++i)
+            bad[i] = '\xff';
+        writeData(bad);
+        REQUIRE(!G.open(path));
+    }
+
+    REQUIRE(!G.open("/nonexistent/file.dg"));
+    std::remove(path.c_str());
+}
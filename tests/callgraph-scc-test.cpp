@@ -0,0 +1,179 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "dg/CallGraph/CallGraphSCC.h"
+
+using namespace dg;
+
+using SCC = CallGraphSCC<unsigned>;
+
+// check that every component ran once and after the components
+// it depends on (given by 'deps')
+template <typename Deps>
+static void checkOrder(const SCC &scc, const std::vector<unsigned> &order,
+                       Deps deps) {
+    REQUIRE(order.size() == scc.size());
+    std::vector<int> pos(scc.size(), -1);
+    for (size_t i = 0; i < order.size(); ++i) {
+        REQUIRE(pos[order[i]] == -1);
+        pos[order[i]] = i;
+    }
+    for (const auto &comp : scc) {
+        for (auto dep : deps(comp))
+            REQUIRE(pos[dep] < pos[comp.getID()]);
+    }
+}
+
+static void checkRuns(SCC &scc, unsigned workers) {
+    std::mutex lock;
+    std::vector<unsigned> order;
+    auto record = [&](const SCC::Component &comp) {
+        std::lock_guard<std::mutex> guard(lock);
+        order.push_back(comp.getID());
+    };
+
+    scc.runBottomUp(record, workers);
+    checkOrder(scc, order,
+               [](const SCC::Component &comp) { return comp.getCallees(); });
+
+    order.clear();
+    scc.runTopDown(record, workers);
+    checkOrder(scc, order,
+               [](const SCC::Component &comp) { return comp.getCallers(); });
+}
+
+TEST_CASE("call graph with dense ids", "GenericCallGraph") {
+    GenericCallGraph<unsigned> cg;
+    REQUIRE(cg.empty());
+    REQUIRE(cg.addCall(10, 20));
+    REQUIRE(cg.addCall(10, 30));
+    REQUIRE(!cg.addCall(10, 20));
+    REQUIRE(cg.addCall(20, 10));
+    REQUIRE(cg.addCall(30, 30));
+    REQUIRE(!cg.addCall(30, 30));
+    cg.createNode(40);
+    REQUIRE(cg.size() == 4);
+
+    // the ids are given in the order of creation
+    std::vector<unsigned> values;
+    for (const auto &it : cg) {
+        REQUIRE(cg.getNode(it.second.getID()) == &it.second);
+        REQUIRE(cg.get(it.first) == &it.second);
+        values.push_back(it.first);
+    }
+    REQUIRE(values == std::vector<unsigned>{10, 20, 30, 40});
+
+    const auto *n10 = cg.get(10);
+    const auto *n20 = cg.get(20);
+    const auto *n30 = cg.get(30);
+    REQUIRE(n10->calls(n20));
+    REQUIRE(n20->calls(n10));
+    REQUIRE(!n20->calls(n30));
+    REQUIRE(n30->isCalledBy(n10));
+    REQUIRE(n30->isCalledBy(n30));
+    REQUIRE(cg.callees(10).size() == 2);
+    REQUIRE(cg.callers(30).size() == 2);
+    REQUIRE(cg.callers(40).empty());
+    REQUIRE(cg.callees(50).empty());
+    REQUIRE(cg.get(50) == nullptr);
+}
+
+TEST_CASE("call graph condensation", "CallGraphSCC") {
+    GenericCallGraph<unsigned> cg;
+    // 1 -> 2 -> 3 -> 2, 3 -> 4, 1 -> 5 -> 5, 6
+    cg.addCall(1, 2);
+    cg.addCall(2, 3);
+    cg.addCall(3, 2);
+    cg.addCall(3, 4);
+    cg.addCall(1, 5);
+    cg.addCall(5, 5);
+    cg.createNode(6);
+
+    SCC scc(cg);
+    REQUIRE(scc.size() == 5);
+    REQUIRE(scc.getNumLevels() == 3);
+
+    const auto &C1 = scc.getComponent(cg.get(1));
+    const auto &C2 = scc.getComponent(cg.get(2));
+    const auto &C4 = scc.getComponent(cg.get(4));
+    const auto &C5 = scc.getComponent(cg.get(5));
+    const auto &C6 = scc.getComponent(cg.get(6));
+
+    REQUIRE(&C2 == &scc.getComponent(cg.get(3)));
+    REQUIRE(C2.getNodes().size() == 2);
+    REQUIRE(C2.isRecursive());
+    REQUIRE(C5.isRecursive());
+    REQUIRE(!C1.isRecursive());
+    REQUIRE(!C6.isRecursive());
+
+    REQUIRE(C4.getLevel() == 0);
+    REQUIRE(C2.getLevel() == 1);
+    REQUIRE(C5.getLevel() == 0);
+    REQUIRE(C1.getLevel() == 2);
+    REQUIRE(C6.getLevel() == 0);
+
+    REQUIRE(C2.getCallees() == std::vector<unsigned>{C4.getID()});
+    REQUIRE(C4.getCallers() == std::vector<unsigned>{C2.getID()});
+    REQUIRE(C1.getCallees().size() == 2);
+    REQUIRE(C1.getCallers().empty());
+
+    // bottom-up numbering
+    for (const auto &comp : scc) {
+        for (auto callee : comp.getCallees())
+            REQUIRE(callee < comp.getID());
+    }
+
+    checkRuns(scc, 1);
+    checkRuns(scc, 4);
+}
+
+TEST_CASE("long call chain", "CallGraphSCC") {
+    GenericCallGraph<unsigned> cg;
+    const unsigned N = 100000;
+    for (unsigned i = 0; i < N; ++i)
+        cg.addCall(i, i + 1);
+    // close a cycle in the middle
+    cg.addCall(N / 2, N / 4);
+
+    SCC scc(cg);
+    REQUIRE(scc.size() == N + 1 - N / 4);
+    REQUIRE(scc.getComponent(cg.get(N / 4)).getNodes().size() ==
+            N / 2 - N / 4 + 1);
+    REQUIRE(scc.getComponent(cg.get(0)).getLevel() == N - N / 4);
+}
+
+TEST_CASE("random call graphs", "CallGraphSCC") {
+    std::mt19937 gen(1);
+    for (unsigned round = 0; round < 20; ++round) {
+        GenericCallGraph<unsigned> cg;
+        const unsigned N = 200;
+        std::uniform_int_distribution<unsigned> fun(0, N - 1);
+        for (unsigned i = 0; i < 2 * N; ++i)
+            cg.addCall(fun(gen), fun(gen));
+
+        SCC scc(cg);
+        // the functions are in the same component iff they
+        // reach each other
+        for (const auto &comp : scc) {
+            for (auto callee : comp.getCallees())
+                REQUIRE(callee < comp.getID());
+        }
+        for (auto &it : cg) {
+            for (auto *callee : it.second.getCalls())
+                REQUIRE(callee->getSCCId() <= it.second.getSCCId());
+        }
+
+        std::atomic<unsigned> processed{0};
+        scc.runBottomUp([&](const SCC::Component &comp) {
+            processed += comp.getNodes().size();
+        });
+        REQUIRE(processed == std::distance(cg.begin(), cg.end()));
+
+        checkRuns(scc, 4);
+    }
+}
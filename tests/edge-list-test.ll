@@ -0,0 +1,27 @@
+; The module for edge-list-test.py
+
+@g = global i32 0
+
+define void @set(i32* %x, i32 %v) {
+entry:
+  store i32 %v, i32* %x
+  store i32 %v, i32* @g
+  ret void
+}
+
+define i32 @main() {
+entry:
+  %a = alloca i32
+  call void @set(i32* %a, i32 1)
+  %x = load i32, i32* %a
+  %c = icmp eq i32 %x, 1
+  br i1 %c, label %then, label %end
+
+then:
+  call void @set(i32* %a, i32 2)
+  br label %end
+
+end:
+  %y = load i32, i32* @g
+  ret i32 %y
+}
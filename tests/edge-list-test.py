@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+
+# Dump the graphs of a module as JSON edge lists (to stdout, to a file
+# and sharded per function) and check that the output parses and that
+# the ids of nodes are unique across the shards.
+# Usage: edge-list-test.py module.ll (run in the directory with tools)
+
+from glob import glob
+from json import load, loads
+from os import remove
+from os.path import abspath, basename, join
+from shutil import copy
+from subprocess import DEVNULL, PIPE, run
+from sys import argv
+from tempfile import TemporaryDirectory
+
+failed = False
+
+
+def check(what, cond):
+    global failed
+    print(what, end='')
+    if cond:
+        print("\u001b[32m OK\u001b[0m")
+    else:
+        failed = True
+        print("\u001b[31m NOK\u001b[0m")
+
+
+def dump(tool, args, **kwargs):
+    p = run([abspath(tool)] + args, stderr=DEVNULL, **kwargs)
+    check(f"{tool} {' '.join(args)} exits", p.returncode == 0)
+    return p
+
+
+# check the nodes and edges of the graph made of the given parts
+def check_graph(what, parts):
+    ids = [n['id'] for part in parts for n in part['nodes']]
+    check(f"{what}: has nodes", len(ids) > 0)
+    check(f"{what}: ids of nodes are unique", len(ids) == len(set(ids)))
+
+    edges = [e for part in parts for e in part['edges']]
+    check(f"{what}: has edges", len(edges) > 0)
+    check(f"{what}: edges go between the nodes",
+          all(e[0] in ids and e[1] in ids for e in edges))
+    return sorted(ids)
+
+
+def parse_files(what, files):
+    parts = []
+    for f in files:
+        try:
+            with open(f) as fl:
+                parts.append(load(fl))
+        except ValueError:
+            check(f"{what}: {basename(f)} parses", False)
+    return parts
+
+
+with TemporaryDirectory() as tmp:
+    # the tools put the files next to the module
+    module = join(tmp, 'module.ll')
+    copy(argv[1], module)
+
+    # the legacy dependence graph
+    out = dump('./llvm-dg-dump', ['-format=json', module],
+               stdout=PIPE, universal_newlines=True).stdout
+    try:
+        whole = check_graph("llvm-dg-dump to stdout", [loads(out)])
+    except ValueError:
+        check("llvm-dg-dump to stdout parses", False)
+        whole = []
+
+    # stdout appended to a file must not be truncated
+    appended = join(tmp, 'appended.json')
+    with open(appended, 'w') as fl:
+        fl.write('previous content\n')
+    with open(appended, 'a') as fl:
+        dump('./llvm-dg-dump', ['-format=json', module], stdout=fl)
+    with open(appended) as fl:
+        first, rest = fl.read().split('\n', 1)
+    check("stdout appended to a file keeps the file",
+          first == 'previous content')
+    try:
+        check("stdout appended to a file parses", loads(rest) == loads(out))
+    except ValueError:
+        check("stdout appended to a file parses", False)
+
+    dump('./llvm-dg-dump', ['-format=json', '-shard', module])
+    shards = glob(module + '.*.json')
+    check("llvm-dg-dump -shard writes globals and both functions",
+          len(shards) == 3)
+    sharded = check_graph("llvm-dg-dump -shard",
+                          parse_files("llvm-dg-dump -shard", shards))
+    check("llvm-dg-dump -shard dumps the same nodes", sharded == whole)
+
+    # the system dependence graph
+    for f in shards:
+        remove(f)
+    dump('./llvm-sdg-dump', ['-format=json', module])
+    whole = check_graph("llvm-sdg-dump",
+                        parse_files("llvm-sdg-dump", glob(module + '.json')))
+
+    dump('./llvm-sdg-dump', ['-format=json', '-shard', module])
+    shards = glob(module + '.*.json')
+    check("llvm-sdg-dump -shard writes both functions", len(shards) == 2)
+    sharded = check_graph("llvm-sdg-dump -shard",
+                          parse_files("llvm-sdg-dump -shard", shards))
+    check("llvm-sdg-dump -shard dumps the same nodes", sharded == whole)
+
+exit(failed)
@@ -1,7 +1,25 @@
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "dg/BinaryGraph.h"
 #include "dg/DFS.h"
+#include "dg/legacy/DataFlowAnalysis.h"
+#include "dg/llvm/CallGraph/CallGraph.h"
+#include "dg/llvm/LLVMDG2Binary.h"
 #include "dg/llvm/LLVMDependenceGraph.h"
+#include "dg/llvm/LLVMDependenceGraphBuilder.h"
 
 TEST_CASE("reference counting test", "LLVM DG") {
     using namespace dg;
@@ -43,3 +61,263 @@ TEST_CASE("reference counting test", "LLVM DG") {
     delete entryBB1;
     delete entryBB2;
 }
+
+namespace {
+
+// the length of the longest path from the entry (at most 'max')
+class PathLength : public dg::legacy::BBlockDataFlowAnalysis<dg::LLVMNode> {
+    unsigned max;
+
+  public:
+    std::map<dg::LLVMBBlock *, unsigned> length;
+
+    PathLength(dg::LLVMBBlock *entry, uint32_t flags, unsigned max)
+            : dg::legacy::BBlockDataFlowAnalysis<dg::LLVMNode>(entry, flags),
+              max(max) {}
+
+    bool runOnBlock(dg::LLVMBBlock *BB) override {
+        unsigned len = 1;
+        for (auto *pred : BB->predecessors())
+            len = std::max(len, std::min(max, length[pred] + 1));
+
+        unsigned &cur = length[BB];
+        if (cur == len)
+            return false;
+        cur = len;
+        return true;
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("data flow worklist", "LLVM DG") {
+    using namespace dg;
+
+    // A -> B -> C -> D
+    //      ^----'
+    LLVMBBlock A, B, C, D;
+    A.addSuccessor(&B);
+    B.addSuccessor(&C);
+    C.addSuccessor(&B);
+    C.addSuccessor(&D);
+
+    PathLength sweep(&A, legacy::DATAFLOW_SWEEP, 10);
+    sweep.run();
+    PathLength worklist(&A, 0, 10);
+    worklist.run();
+
+    REQUIRE(worklist.length == sweep.length);
+    REQUIRE(worklist.length[&A] == 1);
+    REQUIRE(worklist.length[&B] == 10);
+    REQUIRE(worklist.length[&C] == 10);
+    REQUIRE(worklist.length[&D] == 10);
+    REQUIRE(worklist.getStatistics().getProcessedBlocks() <
+            sweep.getStatistics().getProcessedBlocks());
+}
+
+TEST_CASE("call graph of function pointers", "LLVM DG") {
+    using namespace dg;
+
+    const char *code = R"(
+@tab = global [7 x i8*] [
+  i8* bitcast (void (i32)* @f0 to i8*),
+  i8* bitcast (void (i8*)* @f1 to i8*),
+  i8* bitcast (void (double)* @f2 to i8*),
+  i8* bitcast (void ()* @f3 to i8*),
+  i8* bitcast (void (<2 x float>)* @f4 to i8*),
+  i8* bitcast (i32 (i32, i32)* @f5 to i8*),
+  i8* bitcast (void (i32, ...)* @f6 to i8*)]
+
+define void @f0(i32 %a) {
+  ret void
+}
+define void @f1(i8* %a) {
+  ret void
+}
+define void @f2(double %a) {
+  ret void
+}
+define void @f3() {
+  ret void
+}
+define void @f4(<2 x float> %a) {
+  ret void
+}
+define i32 @f5(i32 %a, i32 %b) {
+  ret i32 0
+}
+define void @f6(i32 %a, ...) {
+  ret void
+}
+
+define void @callint(void (i64)* %p) {
+  call void %p(i64 0)
+  ret void
+}
+define void @callvec(void (<1 x i64>)* %p) {
+  call void %p(<1 x i64> zeroinitializer)
+  ret void
+}
+define void @main() {
+  call void @callint(void (i64)* bitcast (void (i32)* @f0 to void (i64)*))
+  ret void
+}
+)";
+
+    llvm::LLVMContext ctx;
+    llvm::SMDiagnostic err;
+    auto M = llvm::parseAssemblyString(code, err, ctx);
+    REQUIRE(M);
+
+    auto names = [](const std::vector<const llvm::Function *> &funs) {
+        std::vector<std::string> ret;
+        for (const auto *F : funs)
+            ret.push_back(F->getName().str());
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    };
+
+    llvmdg::LazyLLVMCallGraph lazy(M.get());
+    llvmdg::LazyLLVMCallGraph eager(M.get(), nullptr, /* eager = */ true);
+    eager.build();
+
+    for (auto *CG : {&lazy, &eager}) {
+        // functions with fewer parameters may be called too
+        REQUIRE(names(CG->callees(M->getFunction("callint"))) ==
+                std::vector<std::string>{"f0", "f1", "f3", "f6"});
+        // vectors of the same size are compatible
+        REQUIRE(names(CG->callees(M->getFunction("callvec"))) ==
+                std::vector<std::string>{"f3", "f4"});
+        REQUIRE(names(CG->callers(M->getFunction("f0"))) ==
+                std::vector<std::string>{"callint"});
+        REQUIRE(CG->callers(M->getFunction("f2")).empty());
+        REQUIRE(CG->getCallsOf(M->getFunction("f3")).size() == 2);
+    }
+}
+
+TEST_CASE("call graph of pointer analysis", "LLVM DG") {
+    using namespace dg;
+
+    const char *code = R"(
+define void @f() {
+  ret void
+}
+define void @g() {
+  call void @f()
+  ret void
+}
+define void @main() {
+  %p = alloca void ()*
+  store void ()* @g, void ()** %p
+  %fp = load void ()*, void ()** %p
+  call void %fp()
+  call void @f()
+  ret void
+}
+)";
+
+    llvm::LLVMContext ctx;
+    llvm::SMDiagnostic err;
+    auto M = llvm::parseAssemblyString(code, err, ctx);
+    REQUIRE(M);
+
+    DGLLVMPointerAnalysis PTA(M.get());
+    PTA.run();
+    llvmdg::CallGraph CG(PTA.getPTA()->getPG()->getCallGraph());
+
+    auto names = [](const std::vector<const llvm::Function *> &funs) {
+        std::vector<std::string> ret;
+        for (const auto *F : funs)
+            ret.push_back(F->getName().str());
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    };
+
+    const auto *main = M->getFunction("main");
+    const auto *f = M->getFunction("f");
+    const auto *g = M->getFunction("g");
+    REQUIRE(names(CG.getCallees(main)) == std::vector<std::string>{"f", "g"});
+    REQUIRE(names(CG.getCallers(f)) == std::vector<std::string>{"g", "main"});
+    REQUIRE(CG.getCallers(main).empty());
+    REQUIRE(CG.getCallees(f).empty());
+    // the vectors are kept by the call graph, not built for every query
+    REQUIRE(&CG.getCallees(main) == &CG.getCallees(main));
+    REQUIRE(CG.callers(f) == CG.getCallers(f));
+    REQUIRE(CG.calls(main, g));
+    REQUIRE(!CG.calls(g, main));
+}
+
+TEST_CASE("binary graph of LLVM DG", "LLVM DG") {
+    using namespace dg;
+    using namespace dg::binary;
+
+    const char *code = R"(
+define i32 @main() {
+  %a = alloca i32
+  store i32 1, i32* %a
+  %x = load i32, i32* %a
+  %y = add i32 %x, 1
+  ret i32 %y
+}
+)";
+
+    llvm::LLVMContext ctx;
+    llvm::SMDiagnostic err;
+    auto M = llvm::parseAssemblyString(code, err, ctx);
+    REQUIRE(M);
+
+    llvmdg::LLVMDependenceGraphOptions options;
+    llvmdg::LLVMDependenceGraphBuilder builder(M.get(), options);
+    auto dg = builder.build();
+    REQUIRE(dg);
+
+    char path[] = "/tmp/dg-binary-graph-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::close(fd);
+    REQUIRE(writeBinaryGraph(dg.get(), path));
+
+    BinaryGraph G;
+    REQUIRE(G.open(path));
+    auto main = G.findFunction("main");
+    REQUIRE(main != NONE);
+
+    // the nodes of the instructions by their indices
+    std::vector<uint32_t> inst(5, NONE);
+    const auto &F = G.getFunction(main);
+    for (auto n = F.firstNode; n < F.firstNode + F.numNodes; ++n) {
+        const auto &node = G.getNode(n);
+        if (node.kind == NodeKind::VALUE &&
+            node.valueKind == ValueKind::INSTRUCTION && node.index < 5)
+            inst[node.index] = n;
+    }
+    REQUIRE(std::find(inst.begin(), inst.end(), NONE) == inst.end());
+
+    auto successors = [&G](EdgeKind kind, uint32_t n) {
+        auto R = G.getSuccessors(kind, n);
+        return std::vector<uint32_t>(R.begin(), R.end());
+    };
+    auto predecessors = [&G](EdgeKind kind, uint32_t n) {
+        auto R = G.getPredecessors(kind, n);
+        return std::vector<uint32_t>(R.begin(), R.end());
+    };
+
+    // the edges go from the value to its users
+    auto users = successors(EdgeKind::USE, inst[0]);
+    REQUIRE(users.size() == 2);
+    REQUIRE(std::find(users.begin(), users.end(), inst[1]) != users.end());
+    REQUIRE(std::find(users.begin(), users.end(), inst[2]) != users.end());
+    REQUIRE(successors(EdgeKind::USE, inst[2]) ==
+            std::vector<uint32_t>{inst[3]});
+    REQUIRE(predecessors(EdgeKind::USE, inst[4]) ==
+            std::vector<uint32_t>{inst[3]});
+    REQUIRE(successors(EdgeKind::USE, inst[4]).empty());
+
+    // the load reads the memory written by the store
+    REQUIRE(successors(EdgeKind::DATA, inst[1]) ==
+            std::vector<uint32_t>{inst[2]});
+    REQUIRE(predecessors(EdgeKind::DATA, inst[1]).empty());
+
+    G.close();
+    std::remove(path);
+}
@@ -0,0 +1,231 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "dg/llvm/PointerAnalysis/PointerAnalysis.h"
+
+using namespace dg;
+
+static const char *code = R"(
+%struct.S = type { i32*, void (i32**)* }
+
+@g = global i32 0
+@s = global %struct.S { i32* @g, void (i32**)* @set }
+
+define void @set(i32** %p) {
+  store i32* @g, i32** %p
+  ret void
+}
+
+define i32 @main() {
+  %a = alloca i32*
+  %fp = getelementptr %struct.S, %struct.S* @s, i32 0, i32 1
+  %f = load void (i32**)*, void (i32**)** %fp
+  call void %f(i32** %a)
+  %x = load i32*, i32** %a
+  %gp = getelementptr %struct.S, %struct.S* @s, i32 0, i32 0
+  %y = load i32*, i32** %gp
+  ret i32 0
+}
+)";
+
+static std::unique_ptr<llvm::Module> parse(llvm::LLVMContext &ctx,
+                                           const std::string &str = code) {
+    llvm::SMDiagnostic err;
+    auto M = llvm::parseAssemblyString(str, err, ctx);
+    REQUIRE(M);
+    return M;
+}
+
+// the points-to sets of the instructions in main as strings
+static std::vector<std::string> getPointsTo(DGLLVMPointerAnalysis &PTA,
+                                            const llvm::Module &M) {
+    std::vector<std::string> ret;
+    for (const auto &I : llvm::instructions(*M.getFunction("main"))) {
+        if (!I.getType()->isPointerTy())
+            continue;
+        std::vector<std::string> pts;
+        for (const auto &ptr : PTA.getLLVMPointsTo(&I))
+            pts.push_back(ptr.value->getName().str() + "+" +
+                          std::to_string(*ptr.offset));
+        std::sort(pts.begin(), pts.end());
+        std::string str = I.getName().str() + ":";
+        for (const auto &p : pts)
+            str += " " + p;
+        ret.push_back(str);
+    }
+    return ret;
+}
+
+TEST_CASE("store and load results", "DGLLVMPointerAnalysis") {
+    char path[] = "/tmp/dg-pta-results-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::close(fd);
+
+    llvm::LLVMContext ctx;
+    auto M = parse(ctx);
+
+    LLVMPointerAnalysisOptions opts;
+    opts.saveResultsTo = path;
+    DGLLVMPointerAnalysis PTA(M.get(), opts);
+    PTA.run();
+    REQUIRE(!PTA.hasLoadedResults());
+    auto pts = getPointsTo(PTA, *M);
+    REQUIRE(std::find(pts.begin(), pts.end(), "x: g+0") != pts.end());
+    REQUIRE(std::find(pts.begin(), pts.end(), "f: set+0") != pts.end());
+
+    opts.saveResultsTo.clear();
+    opts.loadResultsFrom = path;
+
+    SECTION("the same module parsed again") {
+        // parsing the module into the same context renames the types
+        auto M2 = parse(ctx);
+        REQUIRE(M2->getGlobalVariable("s")->getValueType()->getStructName() !=
+                "struct.S");
+
+        DGLLVMPointerAnalysis loaded(M2.get(), opts);
+        loaded.run();
+        REQUIRE(loaded.hasLoadedResults());
+        REQUIRE(getPointsTo(loaded, *M2) == pts);
+    }
+
+    SECTION("a different configuration") {
+        opts.invalidateNodes = true;
+        DGLLVMPointerAnalysis other(M.get(), opts);
+        other.run();
+        REQUIRE(!other.hasLoadedResults());
+
+        opts.invalidateNodes = false;
+        opts.addAllocationFunction("my_malloc", AllocationFunction::MALLOC);
+        DGLLVMPointerAnalysis allocs(M.get(), opts);
+        allocs.run();
+        REQUIRE(!allocs.hasLoadedResults());
+    }
+
+    SECTION("a different module") {
+        std::string changed = code;
+        changed.replace(changed.find("store i32* @g"), 13, "store i32* null");
+        llvm::LLVMContext ctx2;
+        auto M2 = parse(ctx2, changed);
+
+        DGLLVMPointerAnalysis other(M2.get(), opts);
+        other.run();
+        REQUIRE(!other.hasLoadedResults());
+    }
+
+    std::remove(path);
+}
+
+static const char *aliasCode = R"(
+@g = global [4 x i32] zeroinitializer
+@h = global i32 0
+
+define i32 @main(i1 %c) {
+  %a = alloca i32
+  %a8 = bitcast i32* %a to i8*
+  %g0 = getelementptr [4 x i32], [4 x i32]* @g, i32 0, i32 0
+  %g1 = getelementptr [4 x i32], [4 x i32]* @g, i32 0, i32 1
+  %g8 = bitcast [4 x i32]* @g to i8*
+  %s = select i1 %c, i32* %g1, i32* @h
+  ret i32 0
+}
+)";
+
+TEST_CASE("alias queries", "DGLLVMPointerAnalysis") {
+    llvm::LLVMContext ctx;
+    auto M = parse(ctx, aliasCode);
+    DGLLVMPointerAnalysis PTA(M.get());
+    PTA.run();
+
+    std::map<std::string, const llvm::Value *> vals;
+    for (const auto &I : llvm::instructions(*M->getFunction("main")))
+        vals[I.getName().str()] = &I;
+    const auto *h = M->getGlobalVariable("h");
+
+    // check the result of both the implementation with the cache
+    // and the generic one, in both orders of the operands
+    auto check = [&PTA](const llvm::Value *v1, Offset len1,
+                        const llvm::Value *v2, Offset len2,
+                        AliasResult expected) {
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(PTA.alias(v1, len1, v2, len2) == expected);
+            REQUIRE(PTA.alias(v2, len2, v1, len1) == expected);
+            REQUIRE(PTA.LLVMPointerAnalysis::alias(v1, len1, v2, len2) ==
+                    expected);
+        }
+        REQUIRE(PTA.mayAlias(v1, len1, v2, len2) ==
+                (expected != AliasResult::NoAlias));
+    };
+
+    SECTION("must alias") {
+        check(vals["g0"], 4, vals["g8"], 4, AliasResult::MustAlias);
+        check(vals["g0"], 4, vals["g8"], 1, AliasResult::MustAlias);
+        check(vals["g1"], 4, vals["g1"], 4, AliasResult::MustAlias);
+    }
+
+    SECTION("no alias") {
+        // adjacent elements of the array
+        check(vals["g0"], 4, vals["g1"], 4, AliasResult::NoAlias);
+        check(vals["g8"], 1, vals["g1"], 4, AliasResult::NoAlias);
+        // different objects
+        check(vals["a"], 4, h, 4, AliasResult::NoAlias);
+        check(vals["s"], 4, vals["g0"], 4, AliasResult::NoAlias);
+        check(vals["a"], Offset::UNKNOWN, vals["g0"], Offset::UNKNOWN,
+              AliasResult::NoAlias);
+    }
+
+    SECTION("may alias") {
+        // the intervals overlap
+        check(vals["g0"], 8, vals["g1"], 4, AliasResult::MayAlias);
+        // unknown lengths
+        check(vals["g0"], Offset::UNKNOWN, vals["g1"], 4,
+              AliasResult::MayAlias);
+        check(vals["g0"], 0, vals["g1"], 4, AliasResult::MayAlias);
+        // one of more targets
+        check(vals["s"], 4, h, 4, AliasResult::MayAlias);
+        check(vals["s"], 4, vals["g1"], 4, AliasResult::MayAlias);
+        // a local variable may be allocated many times
+        check(vals["a"], 4, vals["a8"], 4, AliasResult::MayAlias);
+    }
+}
+
+TEST_CASE("on-demand query over budget", "DGLLVMPointerAnalysis") {
+    llvm::LLVMContext ctx;
+    auto M = parse(ctx);
+    DGLLVMPointerAnalysis whole(M.get());
+    whole.run();
+
+    std::map<std::string, const llvm::Value *> vals;
+    for (const auto &I : llvm::instructions(*M->getFunction("main")))
+        vals[I.getName().str()] = &I;
+
+    // the first query fits into the budget (it resolves the call
+    // via the pointer too), the second one does not
+    LLVMPointerAnalysisOptions opts;
+    opts.maxDemandedNodes = 14;
+    DGLLVMPointerAnalysis PTA(M.get(), opts);
+    REQUIRE(PTA.runOnDemand({vals["gp"]}));
+    const auto *demandGraph = PTA.getPS();
+
+    // the whole analysis must not run on the partially solved graph
+    REQUIRE(PTA.runOnDemand({vals["x"]}));
+    REQUIRE(PTA.getPS() != demandGraph);
+    REQUIRE(getPointsTo(PTA, *M) == getPointsTo(whole, *M));
+    REQUIRE(PTA.getPS()->getNodes().size() ==
+            whole.getPS()->getNodes().size());
+}
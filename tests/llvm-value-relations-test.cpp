@@ -0,0 +1,140 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "dg/llvm/ValueRelations/GraphBuilder.h"
+#include "dg/llvm/ValueRelations/RelationsAnalyzer.h"
+#include "dg/llvm/ValueRelations/StructureAnalyzer.h"
+
+using namespace dg::vr;
+
+// x = y = z = 0;
+// while (x < n) {
+//     while (y < x) { y = z; z = y + 1; }
+//     x = x + 1; z = y;
+// }
+static const char *loops = R"(
+define i32 @main(i32 %n) {
+entry:
+  %x = alloca i32
+  %y = alloca i32
+  %z = alloca i32
+  store i32 0, i32* %x
+  store i32 0, i32* %y
+  store i32 0, i32* %z
+  br label %outer
+outer:
+  %i = load i32, i32* %x
+  %c = icmp slt i32 %i, %n
+  br i1 %c, label %inner.pre, label %exit
+inner.pre:
+  br label %inner
+inner:
+  %j = load i32, i32* %y
+  %d = icmp slt i32 %j, %i
+  br i1 %d, label %inner.body, label %outer.latch
+inner.body:
+  %k = load i32, i32* %z
+  store i32 %k, i32* %y
+  %j1 = add nsw i32 %j, 1
+  store i32 %j1, i32* %z
+  br label %inner
+outer.latch:
+  %i1 = add nsw i32 %i, 1
+  store i32 %i1, i32* %x
+  %yy = load i32, i32* %y
+  store i32 %yy, i32* %z
+  br label %outer
+exit:
+  ret i32 0
+}
+)";
+
+struct Analysis {
+    const llvm::Module &M;
+    VRCodeGraph codeGraph;
+    std::unique_ptr<StructureAnalyzer> structure;
+    RelationsAnalyzerStats stats;
+
+    Analysis(const llvm::Module &m, const RelationsAnalyzerOptions &opts)
+            : M(m) {
+        GraphBuilder gb(M, codeGraph);
+        gb.build();
+        structure.reset(new StructureAnalyzer(M, codeGraph));
+        structure->analyzeBeforeRelationsAnalysis();
+
+        RelationsAnalyzer ra(M, codeGraph, *structure, opts);
+        ra.analyze();
+        stats = ra.getStatistics();
+    }
+
+    // the relations right before the instruction
+    const ValueRelations &before(const llvm::Instruction &I) const {
+        return codeGraph.getVRLocation(&I).relations;
+    }
+};
+
+static std::unique_ptr<llvm::Module> parse(llvm::LLVMContext &ctx) {
+    llvm::SMDiagnostic err;
+    auto M = llvm::parseAssemblyString(loops, err, ctx);
+    REQUIRE(M);
+    return M;
+}
+
+// Check that 'limited' knows nothing that the analysis
+// without any budget does not know
+static void checkWeaker(const Analysis &limited, const Analysis &full) {
+    for (const auto &I : llvm::instructions(*limited.M.getFunction("main"))) {
+        const auto &rels = limited.before(I);
+        const auto &fullRels = full.before(I);
+
+        for (const auto &lt : rels.getValToBucket()) {
+            for (const auto &rt : rels.getValToBucket()) {
+                if (lt.first == rt.first)
+                    continue;
+                auto related = rels.between(lt.first, rt.first);
+                if (related.any())
+                    CHECK(fullRels.are(lt.first, related, rt.first));
+            }
+        }
+    }
+}
+
+TEST_CASE("widening at loop headers", "RelationsAnalyzer") {
+    llvm::LLVMContext ctx;
+    auto M = parse(ctx);
+
+    RelationsAnalyzerOptions opts;
+    Analysis full(*M, opts);
+    REQUIRE(full.stats.widenedLocations == 0);
+
+    opts.maxLoopIterations = 1;
+    Analysis widened(*M, opts);
+    REQUIRE(widened.stats.widenedLocations == 1);
+    REQUIRE(widened.stats.unfinishedFunctions == 0);
+    checkWeaker(widened, full);
+}
+
+TEST_CASE("budget of buckets", "RelationsAnalyzer") {
+    llvm::LLVMContext ctx;
+    auto M = parse(ctx);
+
+    RelationsAnalyzerOptions opts;
+    Analysis full(*M, opts);
+
+    opts.maxBuckets = 3;
+    Analysis limited(*M, opts);
+    REQUIRE(limited.stats.overBudgetLocations > 0);
+    REQUIRE(limited.stats.unfinishedFunctions == 0);
+    checkWeaker(limited, full);
+
+    // the locations over the budget forget all their relations
+    for (const auto &I : llvm::instructions(*M->getFunction("main")))
+        REQUIRE(limited.before(I).getBucketToVals().size() <= opts.maxBuckets);
+}
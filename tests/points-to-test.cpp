@@ -1,8 +1,15 @@
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dg/PointerAnalysis/PointerAnalysisDemand.h"
 #include "dg/PointerAnalysis/PointerAnalysisFI.h"
 #include "dg/PointerAnalysis/PointerAnalysisFS.h"
 #include "dg/PointerAnalysis/PointerGraph.h"
+#include "dg/PointerAnalysis/PointerGraphOptimizations.h"
 
 using namespace dg::pta;
 using dg::Offset;
@@ -257,6 +264,45 @@ void gep3() {
     REQUIRE(L2->doesPointsTo(B));
 }
 
+template <typename PTStoT>
+void gep_collapse() {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *ARRAY = PS.create<PSNodeType::ALLOC>();
+    ARRAY->setSize(40);
+    PSNode *GEP1 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+    PSNode *GEP2 = PS.create<PSNodeType::GEP>(ARRAY, 4);
+    PSNode *S1 = PS.create<PSNodeType::STORE>(A, GEP1);
+    PSNode *S2 = PS.create<PSNodeType::STORE>(B, GEP2);
+    PSNode *GEP3 = PS.create<PSNodeType::GEP>(ARRAY, 0);
+    PSNode *L1 = PS.create<PSNodeType::LOAD>(GEP3);
+
+    A->addSuccessor(B);
+    B->addSuccessor(ARRAY);
+    ARRAY->addSuccessor(GEP1);
+    GEP1->addSuccessor(GEP2);
+    GEP2->addSuccessor(S1);
+    S1->addSuccessor(S2);
+    S2->addSuccessor(GEP3);
+    GEP3->addSuccessor(L1);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+    dg::PointerAnalysisOptions opts;
+    opts.setMaxObjectOffsets(1);
+    PTStoT PA(&PS, opts);
+    PA.run();
+
+    // the second offset collapsed the array
+    REQUIRE(PA.getCollapsedObjects().size() == 1);
+    REQUIRE(PA.getCollapsedObjects()[0] == ARRAY);
+    REQUIRE(GEP2->doesPointsTo(ARRAY, Offset::UNKNOWN));
+    REQUIRE(GEP3->doesPointsTo(ARRAY, Offset::UNKNOWN));
+    REQUIRE(L1->doesPointsTo(A));
+    REQUIRE(L1->doesPointsTo(B));
+}
+
 template <typename PTStoT>
 void gep4() {
     PointerGraph PS;
@@ -877,6 +923,7 @@ TEST_CASE("Flow insensitive", "FI") {
     gep1<dg::pta::PointerAnalysisFI>();
     gep2<dg::pta::PointerAnalysisFI>();
     gep3<dg::pta::PointerAnalysisFI>();
+    gep_collapse<dg::pta::PointerAnalysisFI>();
     gep4<dg::pta::PointerAnalysisFI>();
     gep5<dg::pta::PointerAnalysisFI>();
     nulltest<dg::pta::PointerAnalysisFI>();
@@ -904,6 +951,7 @@ TEST_CASE("Flow sensitive", "FS") {
     gep1<dg::pta::PointerAnalysisFS>();
     gep2<dg::pta::PointerAnalysisFS>();
     gep3<dg::pta::PointerAnalysisFS>();
+    gep_collapse<dg::pta::PointerAnalysisFS>();
     gep4<dg::pta::PointerAnalysisFS>();
     gep5<dg::pta::PointerAnalysisFS>();
     nulltest<dg::pta::PointerAnalysisFS>();
@@ -936,3 +984,220 @@ TEST_CASE("PSNode test", "PSNode") {
     REQUIRE(N2->pointsTo.size() == 1);
     REQUIRE(N2->addPointsTo(N1, 3) == false);
 }
+
+TEST_CASE("Merge equivalent pointers", "PSEquivalentPointersMerger") {
+    using namespace dg::pta;
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    A->setSize(8);
+    PSNode *C1 = PS.create<PSNodeType::CAST>(A);
+    PSNode *G1 = PS.create<PSNodeType::GEP>(C1, 4);
+    PSNode *G2 = PS.create<PSNodeType::GEP>(A, 4);
+    PSNode *P = PS.create<PSNodeType::PHI>(G1, B);
+    PSNode *Q = PS.create<PSNodeType::PHI>(B, G2);
+    PSNode *S = PS.create<PSNodeType::STORE>(P, Q);
+    PSNode *L = PS.create<PSNodeType::LOAD>(Q);
+
+    A->addSuccessor(B);
+    B->addSuccessor(C1);
+    C1->addSuccessor(G1);
+    G1->addSuccessor(G2);
+    G2->addSuccessor(P);
+    P->addSuccessor(Q);
+    Q->addSuccessor(S);
+    S->addSuccessor(L);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+
+    PSEquivalentPointersMerger merger(&PS);
+    REQUIRE(merger.run() == 3);
+
+    auto &mapping = merger.getMapping();
+    REQUIRE(mapping.get(C1) == A);
+    REQUIRE(mapping.get(G2) == G1);
+    REQUIRE(mapping.get(Q) == P);
+    REQUIRE(S->getOperand(0) == P);
+    REQUIRE(S->getOperand(1) == P);
+    REQUIRE(L->getOperand(0) == P);
+    REQUIRE(G1->getOperand(0) == A);
+
+    PointerAnalysisFI PA(&PS);
+    PA.run();
+    REQUIRE(P->doesPointsTo(A, 4));
+    REQUIRE(P->doesPointsTo(B));
+    REQUIRE(L->doesPointsTo(A, 4));
+    REQUIRE(L->doesPointsTo(B));
+}
+
+TEST_CASE("Demand-driven queries", "PointerAnalysis") {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *C = PS.create<PSNodeType::ALLOC>();
+    PSNode *D = PS.create<PSNodeType::ALLOC>();
+    PSNode *S1 = PS.create<PSNodeType::STORE>(A, B);
+    PSNode *S2 = PS.create<PSNodeType::STORE>(C, D);
+    PSNode *S3 = PS.create<PSNodeType::STORE>(D, A);
+    PSNode *L1 = PS.create<PSNodeType::LOAD>(B);
+    PSNode *L2 = PS.create<PSNodeType::LOAD>(L1);
+
+    A->addSuccessor(B);
+    B->addSuccessor(C);
+    C->addSuccessor(D);
+    D->addSuccessor(S1);
+    S1->addSuccessor(S2);
+    S2->addSuccessor(S3);
+    S3->addSuccessor(L1);
+    L1->addSuccessor(L2);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+
+    SECTION("Query") {
+        PointerAnalysisFI PA(&PS);
+        DemandDrivenPointerAnalysis demand(PA);
+        REQUIRE(demand.query({L2}));
+
+        REQUIRE(L1->doesPointsTo(A));
+        REQUIRE(L2->doesPointsTo(D));
+        REQUIRE(L2->pointsTo.size() == 1);
+        REQUIRE(demand.isSolved(S1));
+        REQUIRE(demand.isSolved(S3));
+        // D is never read, so the store to D is irrelevant
+        REQUIRE(!demand.isSolved(S2));
+    }
+
+    SECTION("Budget") {
+        PointerAnalysisFI PA(&PS);
+        DemandDrivenPointerAnalysis demand(PA, 2);
+        REQUIRE(!demand.query({L2}));
+        REQUIRE(!demand.isSolved(L2));
+
+        PA.run();
+        REQUIRE(L2->doesPointsTo(D));
+    }
+}
+
+// sleeps before processing a node, so that the analysis
+// surely runs out of time after the first iteration
+template <typename PTStoT>
+class SlowPointerAnalysis : public PTStoT {
+  public:
+    using PTStoT::PTStoT;
+
+    bool beforeProcessed(PSNode *n) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return PTStoT::beforeProcessed(n);
+    }
+};
+
+// records the calls via pointers that the analysis resolved
+template <typename PTStoT>
+class RecordingPointerAnalysis : public PTStoT {
+  public:
+    using PTStoT::PTStoT;
+
+    std::vector<std::pair<PSNode *, PSNode *>> calls;
+
+    bool functionPointerCall(PSNode *where, PSNode *what) override {
+        calls.emplace_back(where, what);
+        return PTStoT::functionPointerCall(where, what);
+    }
+};
+
+template <typename PTStoT>
+void out_of_memory() {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *S = PS.create<PSNodeType::STORE>(A, B);
+    PSNode *L = PS.create<PSNodeType::LOAD>(B);
+
+    A->addSuccessor(B);
+    B->addSuccessor(S);
+    S->addSuccessor(L);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+
+    // every process uses more than 1 MB of memory,
+    // so we run out of budget after the first iteration
+    dg::PointerAnalysisOptions opts;
+    opts.maxMemory = 1;
+    PTStoT PA(&PS, opts);
+    REQUIRE(PA.run());
+
+    REQUIRE(PA.exceededBudget());
+    // the results are sound
+    REQUIRE(L->doesPointsTo(A));
+    REQUIRE(L->pointsTo.hasUnknown());
+    REQUIRE(A->doesPointsTo(A, 0));
+}
+
+template <typename PTStoT>
+void out_of_time() {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *S = PS.create<PSNodeType::STORE>(A, B);
+    PSNode *L = PS.create<PSNodeType::LOAD>(B);
+
+    A->addSuccessor(B);
+    B->addSuccessor(S);
+    S->addSuccessor(L);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+
+    dg::PointerAnalysisOptions opts;
+    opts.timeout = 1;
+    SlowPointerAnalysis<PTStoT> PA(&PS, opts);
+    REQUIRE(PA.run());
+
+    REQUIRE(PA.exceededBudget());
+    REQUIRE(L->doesPointsTo(A));
+    REQUIRE(L->pointsTo.hasUnknown());
+    REQUIRE(A->doesPointsTo(A, 0));
+}
+
+template <typename PTStoT>
+void out_of_budget_funcptr() {
+    PointerGraph PS;
+    PSNode *F = PS.create<PSNodeType::FUNCTION>();
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *L = PS.create<PSNodeType::LOAD>(A);
+    PSNode *S = PS.create<PSNodeType::STORE>(F, A);
+    PSNode *C = PS.create<PSNodeType::CALL_FUNCPTR>(L);
+
+    // the call is still pending after the first iteration
+    A->addSuccessor(L);
+    L->addSuccessor(S);
+    S->addSuccessor(C);
+    C->addSuccessor(L);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+
+    dg::PointerAnalysisOptions opts;
+    opts.maxMemory = 1;
+    RecordingPointerAnalysis<PTStoT> PA(&PS, opts);
+    REQUIRE(PA.run());
+
+    REQUIRE(PA.exceededBudget());
+    // the call must be resolved to the function whose address is taken
+    REQUIRE(C->doesPointsTo(F, 0));
+    REQUIRE(PA.calls.size() == 1);
+    REQUIRE(PA.calls[0].first == C);
+    REQUIRE(PA.calls[0].second == F);
+}
+
+TEST_CASE("Out of budget", "PointerAnalysis") {
+    out_of_memory<dg::pta::PointerAnalysisFI>();
+    out_of_memory<dg::pta::PointerAnalysisFS>();
+    out_of_time<dg::pta::PointerAnalysisFI>();
+    out_of_time<dg::pta::PointerAnalysisFS>();
+    out_of_budget_funcptr<dg::pta::PointerAnalysisFI>();
+    out_of_budget_funcptr<dg::pta::PointerAnalysisFS>();
+}
@@ -0,0 +1,29 @@
+; The module for slicer-server-test.py
+
+@g = global i32 0
+
+declare void @use_a(i32)
+declare void @use_b(i32)
+
+define void @set(i32* %x, i32 %v) {
+entry:
+  store i32 %v, i32* %x
+  store i32 %v, i32* @g
+  ret void
+}
+
+define i32 @main() {
+entry:
+  %a = alloca i32
+  %b = alloca i32
+  %fp = alloca void (i32*, i32)*
+  store void (i32*, i32)* @set, void (i32*, i32)** %fp
+  %f = load void (i32*, i32)*, void (i32*, i32)** %fp
+  call void %f(i32* %a, i32 1)
+  call void %f(i32* %b, i32 2)
+  %x = load i32, i32* %a
+  call void @use_a(i32 %x)
+  %y = load i32, i32* %b
+  call void @use_b(i32 %y)
+  ret i32 0
+}
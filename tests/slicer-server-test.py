@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+
+# Send several requests to llvm-slicer-server and check that the later
+# requests reuse the results of the earlier ones.
+# Usage: slicer-server-test.py module.ll (run in the directory with tools)
+
+from json import dumps, loads
+from os.path import isfile, join
+from subprocess import DEVNULL, PIPE, Popen
+from sys import argv
+from tempfile import TemporaryDirectory
+
+failed = False
+
+
+def check(what, cond):
+    global failed
+    print(what, end='')
+    if cond:
+        print("\u001b[32m OK\u001b[0m")
+    else:
+        failed = True
+        print("\u001b[31m NOK\u001b[0m")
+
+
+def run(args, requests):
+    p = Popen(['./llvm-slicer-server'] + args, stdin=PIPE, stdout=PIPE,
+              stderr=DEVNULL, universal_newlines=True)
+    out = p.communicate('\n'.join(map(dumps, requests)) + '\n')[0]
+    check(f"llvm-slicer-server {' '.join(args)} exits",
+          p.returncode == 0)
+    return [loads(line) for line in out.splitlines()]
+
+
+module = argv[1]
+with TemporaryDirectory() as tmp:
+    def request(crit, name):
+        return {'module': module, 'c': crit, 'output': join(tmp, name)}
+
+    # cutting off diverging branches (the default), the graph depends
+    # on the slicing criteria, but the results of PTA can be reused
+    resp = run([], [request('use_a', 'a1.bc'), request('use_b', 'b1.bc'),
+                    request('use_b', 'b2.bc')])
+    check("all requests answered", len(resp) == 3)
+    check("all requests sliced",
+          all(r.get('ok') and isfile(r['output']) for r in resp))
+    if len(resp) == 3:
+        check("the first request is not cached",
+              not resp[0]['cached'] and not resp[0]['pta_loaded'])
+        check("the second request loads the results of PTA",
+              resp[1]['pta_loaded'] and not resp[1]['graph_reused'] and
+              resp[1]['cached'])
+        check("the third request reuses the graph",
+              resp[2]['graph_reused'] and resp[2]['cached'])
+
+    # the graph does not depend on the criteria
+    resp = run(['-cutoff-diverging=false'],
+               [request('use_a', 'a3.bc'), request('use_b', 'b3.bc')])
+    check("all requests sliced",
+          len(resp) == 2 and
+          all(r.get('ok') and isfile(r['output']) for r in resp))
+    if len(resp) == 2:
+        check("the second request reuses the graph",
+              not resp[0]['cached'] and resp[1]['graph_reused'])
+
+exit(failed)
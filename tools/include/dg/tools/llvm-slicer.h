@@ -3,7 +3,10 @@
 
 #include <ctime>
 #include <fstream>
+#include <vector>
 
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/Constants.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/raw_os_ostream.h>
 
@@ -74,6 +77,8 @@ class Slicer {
 
     const SlicerOptions &getOptions() const { return _options; }
 
+    dg::LLVMPointerAnalysis *getPTA() { return _builder.getPTA(); }
+
     // Mirror LLVM to nodes of dependence graph,
     // No dependence edges are added here unless the
     // 'compute_deps' parameter is set to true.
@@ -95,8 +100,8 @@ class Slicer {
 
     // Explicitely compute dependencies after building the graph.
     // This method can be used to compute dependencies without
-    // calling mark() afterwards (mark() calls this function).
-    // It must not be called before calling mark() in the future.
+    // calling mark() afterwards (mark() calls this function
+    // if the dependencies have not been computed yet).
     void computeDependencies() {
         assert(!_computed_deps && "Already called computeDependencies()");
         // must call buildDG() before this function
@@ -125,7 +130,8 @@ class Slicer {
         dg::debug::TimeMeasure tm;
 
         // compute dependece edges
-        computeDependencies();
+        if (!_computed_deps)
+            computeDependencies();
 
         // unmark this set of nodes after marking the relevant ones.
         // Used to mimic the Weissers algorithm
@@ -254,12 +260,100 @@ class ModuleWriter {
         return writeModule();
     }
 
+    // Remove functions, global variables and aliases that are not
+    // reachable from the entry function or the preserved functions
+    // via references from bodies of functions, initializers of globals
+    // and aliasees. The symbols are searched only once, so this is
+    // linear in the size of the module, and it removes also unreachable
+    // (mutually) recursive functions that still have some uses.
     void removeUnusedFromModule() {
-        bool fixpoint;
+        using namespace llvm;
+
+        SmallPtrSet<const GlobalValue *, 32> reachable;
+        std::vector<const GlobalValue *> worklist;
+        auto addReachable = [&](const GlobalValue *GV) {
+            if (GV && reachable.insert(GV).second)
+                worklist.push_back(GV);
+        };
+
+        // the constants (e.g., constant expressions) that we searched
+        SmallPtrSet<const Constant *, 32> visitedConstants;
+        std::vector<const Constant *> constants;
+        auto addOperands = [&](const User *U) {
+            for (const auto &op : U->operands()) {
+                if (const auto *GV = dyn_cast<GlobalValue>(op)) {
+                    addReachable(GV);
+                } else if (const auto *C = dyn_cast<Constant>(op)) {
+                    if (visitedConstants.insert(C).second)
+                        constants.push_back(C);
+                }
+            }
+        };
+        auto addReferences = [&](const User *U) {
+            addOperands(U);
+            while (!constants.empty()) {
+                const auto *C = constants.back();
+                constants.pop_back();
+                addOperands(C);
+            }
+        };
+
+        // do not slice away these functions no matter what
+        const auto *entry = M->getFunction(options.dgOptions.entryFunction);
+        if (!entry)
+            return;
+        addReachable(entry);
+        for (const auto &name : options.preservedFunctions)
+            addReachable(M->getFunction(name));
+#if LLVM_VERSION_MAJOR >= 4
+        // we do not remove ifuncs, so keep also their resolvers
+        for (const auto &IF : M->ifuncs())
+            addReachable(&IF);
+#endif
+
+        while (!worklist.empty()) {
+            const auto *GV = worklist.back();
+            worklist.pop_back();
+
+            // initializers, aliasees, personality functions, ...
+            addReferences(GV);
+            if (const auto *F = dyn_cast<Function>(GV)) {
+                for (const auto &B : *F) {
+                    for (const auto &I : B)
+                        addReferences(&I);
+                }
+            }
+        }
+
+        std::vector<GlobalValue *> unreachable;
+        for (auto &F : *M) {
+            if (reachable.count(&F) == 0)
+                unreachable.push_back(&F);
+        }
+        for (auto &G : M->globals()) {
+            if (reachable.count(&G) == 0)
+                unreachable.push_back(&G);
+        }
+        for (auto &A : M->getAliasList()) {
+            if (reachable.count(&A) == 0)
+                unreachable.push_back(&A);
+        }
 
-        do {
-            fixpoint = _removeUnusedFromModule();
-        } while (fixpoint);
+        // the unreachable symbols may refer to each other,
+        // so drop all the references before erasing them
+        for (auto *GV : unreachable) {
+            // dropAllReferences() is not virtual
+            if (auto *F = dyn_cast<Function>(GV))
+                F->dropAllReferences();
+            else if (auto *G = dyn_cast<GlobalVariable>(GV))
+                G->dropAllReferences();
+            else
+                GV->dropAllReferences();
+        }
+        for (auto *GV : unreachable) {
+            GV->removeDeadConstantUsers();
+            GV->eraseFromParent();
+        }
     }
 
     // after we slice the LLVM, we somethimes have troubles
@@ -338,54 +432,6 @@ class ModuleWriter {
         // exit code
         return 0;
     }
-
-    bool _removeUnusedFromModule() {
-        using namespace llvm;
-        // do not slice away these functions no matter what
-        // FIXME do it a vector and fill it dynamically according
-        // to what is the setup (like for sv-comp or general..)
-        const char *keep[] = {options.dgOptions.entryFunction.c_str()};
-
-        // when erasing while iterating the slicer crashes
-        // so set the to be erased values into container
-        // and then erase them
-        std::set<Function *> funs;
-        std::set<GlobalVariable *> globals;
-        std::set<GlobalAlias *> aliases;
-
-        for (auto &I : *M) {
-            Function *func = &I;
-            if (array_match(func->getName(), keep))
-                continue;
-
-            // if the function is unused or we haven't constructed it
-            // at all in dependence graph, we can remove it
-            // (it may have some uses though - like when one
-            // unused func calls the other unused func
-            if (func->hasNUses(0))
-                funs.insert(func);
-        }
-
-        for (auto I = M->global_begin(), E = M->global_end(); I != E; ++I) {
-            GlobalVariable *gv = &*I;
-            if (gv->hasNUses(0))
-                globals.insert(gv);
-        }
-
-        for (GlobalAlias &ga : M->getAliasList()) {
-            if (ga.hasNUses(0))
-                aliases.insert(&ga);
-        }
-
-        for (Function *f : funs)
-            f->eraseFromParent();
-        for (GlobalVariable *gv : globals)
-            gv->eraseFromParent();
-        for (GlobalAlias *ga : aliases)
-            ga->eraseFromParent();
-
-        return (!funs.empty() || !globals.empty() || !aliases.empty());
-    }
 };
 
 class DGDumper {
@@ -470,11 +516,16 @@ class ModuleAnnotator {
     const SlicerOptions &options;
     LLVMDependenceGraph *dg;
     AnnotationOptsT annotationOptions;
+    bool onlySliced;
+    // the number of threads that compute the annotations
+    unsigned workers;
 
   public:
     ModuleAnnotator(const SlicerOptions &o, LLVMDependenceGraph *dg,
-                    AnnotationOptsT annotO)
-            : options(o), dg(dg), annotationOptions(annotO) {}
+                    AnnotationOptsT annotO, bool onlySliced = false,
+                    unsigned workers = 1)
+            : options(o), dg(dg), annotationOptions(annotO),
+              onlySliced(onlySliced), workers(workers) {}
 
     bool shouldAnnotate() const { return annotationOptions != 0; }
 
@@ -531,13 +582,14 @@ class ModuleAnnotator {
 
         llvm::errs() << "[llvm-slicer] Saving IR with annotations to " << fl
                      << "\n";
-        auto *annot = new dg::debug::LLVMDGAssemblyAnnotationWriter(
+        dg::debug::LLVMDGAssemblyAnnotationWriter annot(
                 annotationOptions, dg->getPTA(), dg->getDDA(), criteria);
-        annot->emitModuleComment(std::move(module_comment));
+        annot.emitModuleComment(std::move(module_comment));
+        // without the slicing criteria, there is no slice yet
+        annot.setOnlySlicedFunctions(onlySliced && criteria);
         llvm::Module *M = dg->getModule();
-        M->print(outputstream, annot);
-
-        delete annot;
+        annot.prepare(*M, workers);
+        M->print(outputstream, &annot);
     }
 };
 
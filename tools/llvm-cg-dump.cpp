@@ -45,11 +45,17 @@ llvm::cl::opt<bool> lazy("lazy-cg",
                          llvm::cl::desc("Use the LazyLLVMCallGraph."),
                          llvm::cl::init(true), llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> eager(
+        "eager-cg",
+        llvm::cl::desc("Build the LazyLLVMCallGraph of the whole module "
+                       "in one pass (default=false)."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 static void dumpCallGraph(llvmdg::CallGraph &CG) {
     std::cout << "digraph CallGraph {\n";
 
     for (const auto *f : CG.functions()) {
-        for (const auto *c : CG.callees(f)) {
+        for (const auto *c : CG.getCallees(f)) {
             std::cout << "  \"" << f->getName().str() << "\" -> \""
                       << c->getName().str() << "\"\n";
         }
@@ -85,7 +91,7 @@ int main(int argc, char *argv[]) {
             SVFPointerAnalysis PTA(M.get(), ptaopts);
             PTA.run();
 
-            llvmdg::CallGraph CG(M.get(), &PTA, lazy);
+            llvmdg::CallGraph CG(M.get(), &PTA, lazy, eager);
             dumpCallGraph(CG);
         } else
 #endif // HAVE_SVF
@@ -94,7 +100,7 @@ int main(int argc, char *argv[]) {
             PTA.run();
 
             if (lazy) {
-                llvmdg::CallGraph CG(M.get(), &PTA, lazy);
+                llvmdg::CallGraph CG(M.get(), &PTA, lazy, eager);
                 CG.build();
                 dumpCallGraph(CG);
             } else {
@@ -109,7 +115,7 @@ int main(int argc, char *argv[]) {
             return 1;
         }
 
-        llvmdg::CallGraph CG(M.get());
+        llvmdg::CallGraph CG(M.get(), eager);
         CG.build();
         dumpCallGraph(CG);
     }
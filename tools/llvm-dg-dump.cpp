@@ -23,7 +23,9 @@
 #include "dg/PointerAnalysis/PointerAnalysisFS.h"
 #include "dg/PointerAnalysis/PointerAnalysisFSInv.h"
 #include "dg/llvm/DataDependence/DataDependence.h"
+#include "dg/llvm/LLVMDG2Binary.h"
 #include "dg/llvm/LLVMDG2Dot.h"
+#include "dg/llvm/LLVMDG2EdgeList.h"
 #include "dg/llvm/LLVMDependenceGraph.h"
 #include "dg/llvm/LLVMDependenceGraphBuilder.h"
 #include "dg/llvm/LLVMSlicer.h"
@@ -95,6 +97,33 @@ llvm::cl::list<PrintingOpts> print_opts(
                 ),
         llvm::cl::cat(SlicingOpts));
 
+enum class DumpFormat { dot, json, csv, binary };
+
+llvm::cl::opt<DumpFormat> dump_format(
+        "format", llvm::cl::desc("Output format (default=dot)."),
+        llvm::cl::values(
+                clEnumValN(DumpFormat::dot, "dot", "Graphviz dot."),
+                clEnumValN(DumpFormat::json, "json",
+                           "JSON with the list of nodes and edges."),
+                clEnumValN(DumpFormat::csv, "csv",
+                           "CSV with the list of nodes and edges."),
+                clEnumValN(DumpFormat::binary, "binary",
+                           "Compact binary format into <input>.dg "
+                           "(see dg/BinaryGraph.h).")
+#if LLVM_VERSION_MAJOR < 4
+                        ,
+                nullptr
+#endif
+                ),
+        llvm::cl::init(DumpFormat::dot), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> shard(
+        "shard",
+        llvm::cl::desc("With -format=json or csv, dump every function into "
+                       "its own file\n"
+                       "<input>.<function>.(json|csv) (default=false)."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 int main(int argc, char *argv[]) {
     setupStackTraceOnError(argc, argv);
     SlicerOptions options = parseSlicerOptions(argc, argv);
@@ -189,6 +218,30 @@ int main(int argc, char *argv[]) {
     if (!dump_func_only.empty())
         only_func = dump_func_only.c_str();
 
+    if (dump_format == DumpFormat::binary) {
+        std::string fl(options.inputFile);
+        replace_suffix(fl, ".dg");
+        errs() << "Dumping DG to " << fl << "\n";
+        return writeBinaryGraph(dg.get(), fl) ? 0 : 1;
+    }
+
+    if (dump_format != DumpFormat::dot) {
+        LLVMDG2EdgeList dumper(dump_format == DumpFormat::json
+                                       ? EdgeListFormat::JSON
+                                       : EdgeListFormat::CSV,
+                               opts);
+        bool ret;
+        if (shard) {
+            std::string prefix(options.inputFile);
+            replace_suffix(prefix, "");
+            ret = dumper.dumpSharded(prefix, only_func);
+        } else {
+            ret = dumper.dump(nullptr, only_func);
+        }
+
+        return ret ? 0 : 1;
+    }
+
     if (bb_only) {
         LLVMDGDumpBlocks dumper(dg.get(), opts);
         dumper.dump(nullptr, only_func);
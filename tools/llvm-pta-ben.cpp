@@ -107,11 +107,11 @@ static int dump_pointer(const Pointer &ptr, const char *name) {
     return 0;
 }
 
-using AliasResult = int;
-const AliasResult NoAlias = 1;
-const AliasResult MayAlias = 2;
-const AliasResult MustAlias = 3;
-const AliasResult PartialAlias = 4;
+using BenAliasResult = int;
+const BenAliasResult NoAlias = 1;
+const BenAliasResult MayAlias = 2;
+const BenAliasResult MustAlias = 3;
+const BenAliasResult PartialAlias = 4;
 
 static int compare_pointer(const Pointer &ptr1, const Pointer &ptr2) {
     dump_pointer(ptr1, "1");
@@ -148,7 +148,7 @@ static int check_pointer(const Pointer &ptr, const char *name) {
     return NoAlias;
 }
 
-static AliasResult doAlias(DGLLVMPointerAnalysis *pta, llvm::Value *V1,
+static BenAliasResult doAlias(DGLLVMPointerAnalysis *pta, llvm::Value *V1,
                            llvm::Value *V2) {
     PSNode *p1 = pta->getPointsToNode(V1);
     PSNode *p2 = pta->getPointsToNode(V2);
@@ -259,7 +259,7 @@ static void evalPSNode(DGLLVMPointerAnalysis *pta, PSNode *node) {
     llvm::Value *V1 = call->getArgOperand(0);
     llvm::Value *V2 = call->getArgOperand(1);
     const char *ex, *s, *score;
-    AliasResult aares = doAlias(pta, V1, V2);
+    BenAliasResult aares = doAlias(pta, V1, V2);
     // bool r = false;
 
     if (fun.equals(NOALIAS)) {
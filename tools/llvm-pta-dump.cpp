@@ -88,6 +88,22 @@ llvm::cl::opt<std::string>
                                     "function(s) (separated by comma)."),
                      llvm::cl::init(""), llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<std::string> query(
+        "query",
+        llvm::cl::desc("Compute and show only the points-to sets of the given "
+                       "values (separated by comma). A value is given as "
+                       "'fun:name' for instructions and arguments or as "
+                       "'name' for globals. The flow-insensitive analysis "
+                       "answers such queries on demand."),
+        llvm::cl::init(""), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<uint64_t> query_budget(
+        "query-budget",
+        llvm::cl::desc("The maximal number of nodes processed by a "
+                       "demand-driven query before running the whole "
+                       "analysis (default=0 - unlimited)."),
+        llvm::cl::init(0), llvm::cl::cat(SlicingOpts));
+
 llvm::cl::opt<bool> _stats("statistics",
                            llvm::cl::desc("Dump statistics (default=false)."),
                            llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
@@ -186,6 +202,67 @@ static std::string getInstName(const llvm::Value *val) {
     return ostr.str();
 }
 
+static void dumpLLVMPointsTo(const llvm::Value *val, LLVMPointsToSet &pts) {
+    std::cout << valToStr(val) << "\n";
+    for (const auto &ptr : pts) {
+        std::cout << "  -> " << valToStr(ptr.value) << "\n";
+    }
+    if (pts.hasUnknown()) {
+        std::cout << "  -> unknown\n";
+    }
+    if (pts.hasNull()) {
+        std::cout << "  -> null\n";
+    }
+    if (pts.hasNullWithOffset()) {
+        std::cout << "  -> null + ?\n";
+    }
+    if (pts.hasInvalidated()) {
+        std::cout << "  -> invalidated\n";
+    }
+}
+
+// find the values given as 'fun:name' or 'name' (globals)
+static bool getQueriedValues(const llvm::Module &M,
+                             std::vector<const llvm::Value *> &vals) {
+    for (const auto &q : splitList(query)) {
+        auto pos = q.find(':');
+        if (pos == std::string::npos) {
+            const auto *G = M.getGlobalVariable(q, true);
+            if (!G) {
+                llvm::errs() << "Invalid query: global '" << q
+                             << "' not found in the module\n";
+                return false;
+            }
+            vals.push_back(G);
+            continue;
+        }
+
+        const auto *F = M.getFunction(q.substr(0, pos));
+        const llvm::Value *val = nullptr;
+        if (F && !F->isDeclaration()) {
+            auto name = q.substr(pos + 1);
+            for (const auto &A : F->args()) {
+                if (A.getName() == name)
+                    val = &A;
+            }
+            for (const auto &B : *F) {
+                for (const auto &I : B) {
+                    if (I.getName() == name)
+                        val = &I;
+                }
+            }
+        }
+        if (!val) {
+            llvm::errs() << "Invalid query: value '" << q
+                         << "' not found in the module\n";
+            return false;
+        }
+        vals.push_back(val);
+    }
+
+    return true;
+}
+
 void printPSNodeType(enum PSNodeType type) {
     printf("%s", PSNodeTypeToCString(type));
 }
@@ -500,7 +577,9 @@ static void dumpNodeEdgesToDot(PSNode *node) {
 }
 
 PSNode *getNodePtr(PSNode *ptr) { return ptr; }
-PSNode *getNodePtr(const std::unique_ptr<PSNode> &ptr) { return ptr.get(); }
+PSNode *getNodePtr(const PointerGraph::NodesT::value_type &ptr) {
+    return ptr.get();
+}
 
 template <typename ContT>
 static void dumpToDot(const ContT &nodes, PTType type) {
@@ -714,6 +793,13 @@ static void dumpStats(DGLLVMPointerAnalysis *pta) {
     }
 
     printf("Allocations: %zu\n", allocation_num);
+    const auto &collapsed = pta->getPTA()->getCollapsedObjects();
+    printf("Objects collapsed to unknown offset: %zu\n", collapsed.size());
+    for (auto *obj : collapsed) {
+        printf("  ");
+        printName(obj);
+        printf("\n");
+    }
     printf("Allocations with known size: %zu\n", has_known_size);
     printf("Nodes with non-empty pt-set: %zu\n", nonempty_size);
     printf("Pointers pointing only to known-size allocations: %zu\n",
@@ -799,8 +885,13 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    std::vector<const llvm::Value *> queried;
+    if (!query.empty() && !getQueriedValues(*M, queried))
+        return 1;
+
     TimeMeasure tm;
     auto &opts = options.dgOptions.PTAOptions;
+    opts.maxDemandedNodes = query_budget;
 
 #ifdef HAVE_SVF
     if (opts.isSVF()) {
@@ -821,7 +912,10 @@ int main(int argc, char *argv[]) {
             llvmpta.reset(new DGLLVMPointerAnalysis(M.get(), opts));
 
         tm.start();
-        llvmpta->run();
+        if (queried.empty())
+            llvmpta->run();
+        else
+            llvmpta->runOnDemand(queried);
         tm.stop();
         tm.report("INFO: Pointer analysis took");
 
@@ -851,6 +945,14 @@ int main(int argc, char *argv[]) {
             }
         }
 
+        if (!queried.empty()) {
+            for (const auto *val : queried) {
+                auto pts = llvmpta->getLLVMPointsTo(val);
+                dumpLLVMPointsTo(val, pts);
+            }
+            return 0;
+        }
+
         for (auto &F : *M) {
             if (!display_only_func.empty() &&
                 std::find(display_only_func.begin(), display_only_func.end(),
@@ -875,22 +977,7 @@ int main(int argc, char *argv[]) {
                         continue;
                     }
 
-                    std::cout << valToStr(&I) << "\n";
-                    for (const auto &ptr : pts) {
-                        std::cout << "  -> " << valToStr(ptr.value) << "\n";
-                    }
-                    if (pts.hasUnknown()) {
-                        std::cout << "  -> unknown\n";
-                    }
-                    if (pts.hasNull()) {
-                        std::cout << "  -> null\n";
-                    }
-                    if (pts.hasNullWithOffset()) {
-                        std::cout << "  -> null + ?\n";
-                    }
-                    if (pts.hasInvalidated()) {
-                        std::cout << "  -> invalidated\n";
-                    }
+                    dumpLLVMPointsTo(&I, pts);
                 }
             }
         }
@@ -21,7 +21,9 @@
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include "dg/llvm/SystemDependenceGraph/SDG2Binary.h"
 #include "dg/llvm/SystemDependenceGraph/SDG2Dot.h"
+#include "dg/llvm/SystemDependenceGraph/SDG2EdgeList.h"
 #include "dg/util/debug.h"
 
 using namespace dg;
@@ -38,6 +40,33 @@ llvm::cl::opt<bool> dump_bb_only(
                        " (default=false)."),
         llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+enum class DumpFormat { dot, json, csv, binary };
+
+llvm::cl::opt<DumpFormat> dump_format(
+        "format", llvm::cl::desc("Output format (default=dot)."),
+        llvm::cl::values(
+                clEnumValN(DumpFormat::dot, "dot", "Graphviz dot."),
+                clEnumValN(DumpFormat::json, "json",
+                           "JSON with the list of nodes and edges."),
+                clEnumValN(DumpFormat::csv, "csv",
+                           "CSV with the list of nodes and edges."),
+                clEnumValN(DumpFormat::binary, "binary",
+                           "Compact binary format into <input>.dg "
+                           "(see dg/BinaryGraph.h).")
+#if LLVM_VERSION_MAJOR < 4
+                        ,
+                nullptr
+#endif
+                ),
+        llvm::cl::init(DumpFormat::dot), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> shard(
+        "shard",
+        llvm::cl::desc("With -format=json or csv, dump every function into "
+                       "its own file\n"
+                       "<input>.<function>.(json|csv) (default=false)."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 class SDGDumper {
     const SlicerOptions &options;
     llvmdg::SystemDependenceGraph *dg;
@@ -70,6 +99,29 @@ class SDGDumper {
             dumper.dump(fl);
         }
     }
+
+    bool dumpEdgeList(debug::EdgeListFormat format) {
+        llvmdg::SDG2EdgeList dumper(dg, format);
+
+        std::string fl(options.inputFile);
+        if (shard) {
+            replace_suffix(fl, "");
+            errs() << "Dumping SDG to " << fl << ".*" << dumper.getSuffix()
+                   << "\n";
+            return dumper.dumpSharded(fl);
+        }
+
+        replace_suffix(fl, dumper.getSuffix());
+        errs() << "Dumping SDG to " << fl << "\n";
+        return dumper.dump(fl);
+    }
+
+    bool dumpBinary() {
+        std::string fl(options.inputFile);
+        replace_suffix(fl, ".dg");
+        errs() << "Dumping SDG to " << fl << "\n";
+        return llvmdg::writeBinaryGraph(*dg, fl);
+    }
 };
 
 int main(int argc, char *argv[]) {
@@ -102,7 +154,16 @@ int main(int argc, char *argv[]) {
     llvmdg::SystemDependenceGraph sdg(M.get(), &PTA, &DDA, &CDA);
 
     SDGDumper dumper(options, &sdg, dump_bb_only);
-    dumper.dumpToDot();
+    if (dump_format == DumpFormat::dot) {
+        dumper.dumpToDot();
+    } else if (dump_format == DumpFormat::binary) {
+        if (!dumper.dumpBinary())
+            return 1;
+    } else if (!dumper.dumpEdgeList(dump_format == DumpFormat::json
+                                            ? debug::EdgeListFormat::JSON
+                                            : debug::EdgeListFormat::CSV)) {
+        return 1;
+    }
 
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <cassert>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <llvm/IR/CFG.h>
@@ -220,17 +221,6 @@ static bool instIsCallOf(const llvm::Instruction &I, const std::string &name,
     return false;
 }
 
-static bool fileMatch(const std::string &file, const llvm::Instruction &I) {
-#if LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 7
-    const auto *F = I.getParent()->getParent();
-    const auto *subprog = llvm::cast<llvm::DISubprogram>(
-            F->getMetadata(llvm::LLVMContext::MD_dbg));
-#else
-    const auto *subprog = I.getFunction()->getSubprogram();
-#endif
-    return subprog->getFile()->getFilename() == file;
-}
-
 static bool fileMatch(const std::string &file, const llvm::GlobalVariable &G) {
 #if LLVM_VERSION_MAJOR < 4
     return true;
@@ -397,10 +387,133 @@ static std::string parseObj(const std::vector<std::string> &parts) {
     return parts[parts.size() - 1];
 }
 
+static unsigned getLine(const llvm::Instruction &I) {
+    const auto &Loc = I.getDebugLoc();
+#if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR < 7)
+    return Loc.getLine();
+#else
+    return Loc ? Loc.getLine() : 0;
+#endif
+}
+
+static std::string getFile(const llvm::Function &F) {
+#if LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 7
+    const auto *subprog = llvm::cast_or_null<llvm::DISubprogram>(
+            F.getMetadata(llvm::LLVMContext::MD_dbg));
+#else
+    const auto *subprog = F.getSubprogram();
+#endif
+    return subprog ? subprog->getFile()->getFilename().str() : "";
+}
+
+///
+// Index of the instructions that may be slicing criteria. It is built
+// once and then all the criteria are resolved against it, so that we
+// do not walk over the whole module and re-read debug info
+// for every criterion.
+class CriteriaIndex {
+    using InstsT = std::vector<const llvm::Instruction *>;
+
+    InstsT _all;
+    // instructions that access memory and calls, that is,
+    // instructions that may use a variable or call a function
+    InstsT _memAccesses;
+    // calls via a pointer (may call any function)
+    InstsT _indirectCalls;
+    std::unordered_map<unsigned, InstsT> _byLine;
+    std::unordered_map<std::string, InstsT> _byFunction;
+    std::unordered_map<std::string, InstsT> _callsOf;
+    std::unordered_map<const llvm::Function *, std::string> _files;
+
+    static const InstsT &getOrEmpty(
+            const std::unordered_map<std::string, InstsT> &map,
+            const std::string &key) {
+        static const InstsT empty;
+        auto it = map.find(key);
+        return it == map.end() ? empty : it->second;
+    }
+
+    void add(const llvm::Function &F) {
+        _files.emplace(&F, getFile(F));
+        auto &funInsts = _byFunction[F.getName().str()];
+
+        for (const auto &I : llvm::instructions(F)) {
+            _all.push_back(&I);
+            funInsts.push_back(&I);
+
+            if (unsigned line = getLine(I))
+                _byLine[line].push_back(&I);
+
+            if (I.mayReadOrWriteMemory() || llvm::isa<llvm::CallInst>(I))
+                _memAccesses.push_back(&I);
+
+            if (const auto *C = llvm::dyn_cast<llvm::CallInst>(&I)) {
+                if (const auto *fun = C->getCalledFunction())
+                    _callsOf[fun->getName().str()].push_back(&I);
+                else
+                    _indirectCalls.push_back(&I);
+            }
+        }
+    }
+
+  public:
+    CriteriaIndex(llvm::Module &M, bool constructed_only) {
+        if (constructed_only) {
+            for (auto &it : getConstructedFunctions())
+                add(*llvm::cast<llvm::Function>(it.first));
+        } else {
+            for (auto &F : M)
+                add(F);
+        }
+    }
+
+    bool fileMatch(const std::string &file, const llvm::Instruction &I) const {
+        auto it = _files.find(I.getParent()->getParent());
+        assert(it != _files.end() && "Instruction not in the index");
+        return it->second == file;
+    }
+
+    // instructions that can match the criterion (a superset
+    // of the matching instructions, they must be checked further)
+    const InstsT &getCandidates(const std::string &fun, unsigned line,
+                                const std::string &obj,
+                                InstsT &tmp) const {
+        static const InstsT empty;
+        if (line > 0) {
+            auto it = _byLine.find(line);
+            return it == _byLine.end() ? empty : it->second;
+        }
+
+        if (!fun.empty())
+            return getOrEmpty(_byFunction, fun);
+
+        if (obj.empty())
+            return _all;
+
+        auto len = obj.length();
+        bool isfunc = len > 2 && obj.compare(len - 2, 2, "()") == 0;
+        if (isfunc && obj[0] != '&') {
+            auto name = obj.substr(obj[0] == '@' ? 1 : 0);
+            name = name.substr(0, name.length() - 2);
+            const auto &direct = getOrEmpty(_callsOf, name);
+            tmp.reserve(direct.size() + _indirectCalls.size());
+            tmp.insert(tmp.end(), direct.begin(), direct.end());
+            tmp.insert(tmp.end(), _indirectCalls.begin(),
+                       _indirectCalls.end());
+            return tmp;
+        }
+
+        if (!isfunc)
+            return _memAccesses;
+
+        return _all;
+    }
+};
+
 static void getCriteriaInstructions(llvm::Module &M, LLVMPointerAnalysis *pta,
+                                    const CriteriaIndex &index,
                                     const std::string &criterion,
-                                    std::set<const llvm::Value *> &result,
-                                    bool constructed_only = false) {
+                                    std::set<const llvm::Value *> &result) {
     assert(!criterion.empty() && "No criteria given");
 
     auto parts = splitList(criterion, '#');
@@ -437,33 +550,15 @@ static void getCriteriaInstructions(llvm::Module &M, LLVMPointerAnalysis *pta,
         }
     }
 
-    if (constructed_only) {
-        DBG(llvm - slicer,
-            "Checking constructed functions for slicing criteria");
-
-        for (auto &it : getConstructedFunctions()) {
-            for (auto &I :
-                 llvm::instructions(*llvm::cast<llvm::Function>(it.first))) {
-                if (!file.empty() && !fileMatch(file, I))
-                    continue;
-
-                if (instMatchesCrit(I, fun, line, obj, pta)) {
-                    result.insert(&I);
-                }
-            }
-        }
-    } else {
-        DBG(llvm - slicer, "Checking all instructions for slicing criteria");
+    DBG(llvm - slicer, "Checking indexed instructions for slicing criteria");
 
-        for (auto &F : M) {
-            for (auto &I : llvm::instructions(F)) {
-                if (file != "" && !fileMatch(file, I))
-                    continue;
+    std::vector<const llvm::Instruction *> tmp;
+    for (const auto *I : index.getCandidates(fun, line, obj, tmp)) {
+        if (!file.empty() && !index.fileMatch(file, *I))
+            continue;
 
-                if (instMatchesCrit(I, fun, line, obj, pta)) {
-                    result.insert(&I);
-                }
-            }
+        if (instMatchesCrit(*I, fun, line, obj, pta)) {
+            result.insert(I);
         }
     }
 }
@@ -552,6 +647,8 @@ static std::vector<SlicingCriteriaSet> getSlicingCriteriaInstructions(
     std::vector<SlicingCriteriaSet> result;
     std::set<const llvm::Value *> secondaryToAll;
 
+    const CriteriaIndex index(M, constructed_only);
+
     // map the criteria to instructions
     for (const auto &crit : criteria) {
         if (crit.empty())
@@ -571,8 +668,7 @@ static std::vector<SlicingCriteriaSet> getSlicingCriteriaInstructions(
         // be added to every primary SC
         bool ssctoall = primsec[0].empty() && primsec.size() > 1;
         if (!primsec[0].empty()) {
-            getCriteriaInstructions(M, pta, primsec[0], SC.primary,
-                                    constructed_only);
+            getCriteriaInstructions(M, pta, index, primsec[0], SC.primary);
         }
 
         if (!SC.primary.empty()) {
@@ -609,8 +705,8 @@ static std::vector<SlicingCriteriaSet> getSlicingCriteriaInstructions(
         }
 
         if ((!SC.primary.empty() || ssctoall) && primsec.size() > 1) {
-            getCriteriaInstructions(M, pta, primsec[1], SC.secondary,
-                                    constructed_only);
+            getCriteriaInstructions(M, pta, index, primsec[1],
+                                    SC.secondary);
 
             if (!SC.secondary.empty()) {
                 size_t n = 0;
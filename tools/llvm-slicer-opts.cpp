@@ -151,6 +151,15 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit,
                     "a separate analysis.\n"),
             llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<unsigned> cdaWorkers(
+            "cda-workers",
+            llvm::cl::desc("The number of threads that compute "
+                           "post-dominators of functions\n"
+                           "for -cda=standard (default=1, 0 means the "
+                           "number of CPUs).\n"),
+            llvm::cl::value_desc("N"), llvm::cl::init(1),
+            llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<uint64_t> ptaFieldSensitivity(
             "pta-field-sensitive",
             llvm::cl::desc("Make PTA field sensitive/insensitive. The offset "
@@ -162,6 +171,57 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit,
             llvm::cl::value_desc("N"), llvm::cl::init(dg::Offset::UNKNOWN),
             llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<bool> ptaMergeEquivalent(
+            "pta-merge-equivalent",
+            llvm::cl::desc("Collapse pointers that provably have the same "
+                           "points-to set\n"
+                           "before running PTA (default=false).\n"),
+            llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<uint64_t> ptaMaxObjectOffsets(
+            "pta-max-object-offsets",
+            llvm::cl::desc("Collapse an object to Offset::UNKNOWN when "
+                           "pointers with\n"
+                           "more than N distinct offsets point into it "
+                           "(default=0 - unlimited).\n"),
+            llvm::cl::value_desc("N"), llvm::cl::init(0),
+            llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> ptaTimeout(
+            "pta-timeout",
+            llvm::cl::desc("Stop PTA after N milliseconds and let the "
+                           "unprocessed\n"
+                           "pointers point to unknown memory "
+                           "(default=0 - unlimited).\n"),
+            llvm::cl::value_desc("N"), llvm::cl::init(0),
+            llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<uint64_t> ptaMaxRSS(
+            "pta-max-rss",
+            llvm::cl::desc("Stop PTA when the process uses more than N MB "
+                           "of memory\n"
+                           "and let the unprocessed pointers point to unknown "
+                           "memory\n"
+                           "(default=0 - unlimited).\n"),
+            llvm::cl::value_desc("N"), llvm::cl::init(0),
+            llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<std::string> ptaLoadResults(
+            "pta-load-results",
+            llvm::cl::desc("Load the results of pointer analysis from the "
+                           "given file\n"
+                           "instead of running the analysis (if they match "
+                           "the module).\n"),
+            llvm::cl::value_desc("file"), llvm::cl::init(""),
+            llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<std::string> ptaSaveResults(
+            "pta-save-results",
+            llvm::cl::desc("Save the results of pointer analysis to the "
+                           "given file.\n"),
+            llvm::cl::value_desc("file"), llvm::cl::init(""),
+            llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<dg::dda::UndefinedFunsBehavior> undefinedFunsBehavior(
             "undefined-funs",
             llvm::cl::desc("Set the behavior of undefined functions\n"),
@@ -413,11 +473,18 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit,
     CDAOptions.interprocedural = interprocCd;
     CDAOptions._icfg = icfgCD;
     CDAOptions.setNodePerInstruction(cdaPerInstr);
+    CDAOptions.workers = cdaWorkers;
 
     addAllocationFuns(dgOptions, allocationFuns);
 
     PTAOptions.entryFunction = entryFunction;
     PTAOptions.fieldSensitivity = dg::Offset(ptaFieldSensitivity);
+    PTAOptions.mergeEquivalentPointers = ptaMergeEquivalent;
+    PTAOptions.maxObjectOffsets = ptaMaxObjectOffsets;
+    PTAOptions.timeout = ptaTimeout;
+    PTAOptions.maxMemory = ptaMaxRSS;
+    PTAOptions.loadResultsFrom = ptaLoadResults;
+    PTAOptions.saveResultsTo = ptaSaveResults;
     PTAOptions.analysisType = ptaType;
     PTAOptions.threads = threads;
 
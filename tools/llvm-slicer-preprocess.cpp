@@ -4,8 +4,8 @@
 #include <llvm/IR/Module.h>
 #include <llvm/Support/raw_os_ostream.h>
 
-#include <set>
-#include <stack>
+#include <cassert>
+#include <unordered_map>
 #include <vector>
 
 #include "dg/llvm/CallGraph/CallGraph.h"
@@ -16,10 +16,54 @@ using namespace llvm;
 namespace dg {
 namespace llvmdg {
 
-template <typename C>
-inline bool hasRelevantPredecessor(llvm::BasicBlock *B, const C &relevant) {
+namespace {
+
+///
+// The blocks of the module numbered densely, so that sets of blocks
+// can be bitvectors. We also remember the blocks that return from
+// each function, so that we do not search for them on every call.
+class NumberedBlocks {
+    std::unordered_map<const llvm::BasicBlock *, unsigned> _ids;
+    std::unordered_map<const llvm::Function *,
+                       std::vector<llvm::BasicBlock *>>
+            _returns;
+
+  public:
+    NumberedBlocks(Module &M) {
+        for (auto &F : M) {
+            auto &rets = _returns[&F];
+            for (auto &B : F) {
+                unsigned id = _ids.size();
+                _ids.emplace(&B, id);
+                if (llvm::isa<llvm::ReturnInst>(B.getTerminator()))
+                    rets.push_back(&B);
+            }
+        }
+    }
+
+    size_t size() const { return _ids.size(); }
+
+    unsigned getID(const llvm::BasicBlock *B) const {
+        auto it = _ids.find(B);
+        assert(it != _ids.end() && "Block is not numbered");
+        return it->second;
+    }
+
+    const std::vector<llvm::BasicBlock *> &
+    getReturns(const llvm::Function *F) const {
+        auto it = _returns.find(F);
+        assert(it != _returns.end() && "Function is not numbered");
+        return it->second;
+    }
+};
+
+} // anonymous namespace
+
+static bool hasRelevantPredecessor(llvm::BasicBlock *B,
+                                   const NumberedBlocks &numbering,
+                                   const std::vector<bool> &relevant) {
     for (auto *p : llvm::predecessors(B)) {
-        if (relevant.count(p) > 0)
+        if (relevant[numbering.getID(p)])
             return true;
     }
     return false;
@@ -34,10 +78,10 @@ bool cutoffDivergingBranches(Module &M, const std::string &entry,
         return false;
     }
 
-    llvmdg::LazyLLVMCallGraph CG(&M);
-    std::set<BasicBlock *> relevant;
-    std::set<BasicBlock *> visited;
-    std::stack<BasicBlock *> queue; // not efficient...
+    // we query the callers of many functions, build the whole
+    // call graph at once instead of going over the module for each
+    llvmdg::LazyLLVMCallGraph CG(&M, nullptr, /* eager = */ true);
+    CG.build();
     auto &Ctx = M.getContext();
     auto *entryFun = M.getFunction(entry);
 
@@ -46,78 +90,67 @@ bool cutoffDivergingBranches(Module &M, const std::string &entry,
         return false;
     }
 
+    const NumberedBlocks numbering(M);
+    // the blocks from which we can reach some slicing criterion
+    // (every queued block is relevant)
+    std::vector<bool> relevant(numbering.size(), false);
+    std::vector<llvm::BasicBlock *> queue;
+
+    auto enqueue = [&](llvm::BasicBlock *B) {
+        auto id = numbering.getID(B);
+        if (!relevant[id]) {
+            relevant[id] = true;
+            queue.push_back(B);
+        }
+    };
+
+    // queue the return blocks of the functions called by 'C'
+    auto enqueueCallees = [&](llvm::CallInst *C) {
+        for (auto *fun : CG.getCalledFunctions(C)) {
+            for (auto *ret : numbering.getReturns(fun))
+                enqueue(ret);
+        }
+    };
+
     // initialize the queue with blocks of slicing criteria
-    for (auto *c : criteria) {
+    for (const auto *c : criteria) {
         auto *I = llvm::dyn_cast<Instruction>(const_cast<llvm::Value *>(c));
         if (!I) {
             continue;
         }
         auto *blk = I->getParent();
         // add the block of slicing criteria
-        if (visited.insert(blk).second) {
-            queue.push(blk);
-        }
+        enqueue(blk);
 
         // add the callers of calls that reach this SC in this block
         for (auto &blkI : *blk) {
             if (&blkI == I)
                 break;
-            auto *blkCall = llvm::dyn_cast<llvm::CallInst>(&blkI);
-            if (!blkCall)
-                continue;
-            for (auto *fun : CG.getCalledFunctions(blkCall)) {
-                for (auto &funBlk : *fun) {
-                    if (llvm::isa<llvm::ReturnInst>(funBlk.getTerminator())) {
-                        if (visited.insert(const_cast<llvm::BasicBlock *>(
-                                                   &funBlk))
-                                    .second) {
-                            queue.push(const_cast<llvm::BasicBlock *>(&funBlk));
-                        }
-                    }
-                }
-            }
+            if (auto *blkCall = llvm::dyn_cast<llvm::CallInst>(&blkI))
+                enqueueCallees(blkCall);
         }
     }
 
     // get all backward reachable blocks in the ICFG, only those blocks
     // can be relevant in the slice
     while (!queue.empty()) {
-        auto *cur = queue.top();
-        queue.pop();
-
-        // paths from this block go to the slicing criteria
-        relevant.insert(cur);
+        auto *cur = queue.back();
+        queue.pop_back();
 
         // queue the blocks from calls in current block
         for (auto &blkI : *cur) {
-            auto *blkCall = llvm::dyn_cast<llvm::CallInst>(&blkI);
-            if (!blkCall)
-                continue;
-            for (auto *fun : CG.getCalledFunctions(blkCall)) {
-                for (auto &funBlk : *fun) {
-                    if (llvm::isa<llvm::ReturnInst>(funBlk.getTerminator())) {
-                        if (visited.insert(const_cast<llvm::BasicBlock *>(
-                                                   &funBlk))
-                                    .second) {
-                            queue.push(const_cast<llvm::BasicBlock *>(&funBlk));
-                        }
-                    }
-                }
-            }
+            if (auto *blkCall = llvm::dyn_cast<llvm::CallInst>(&blkI))
+                enqueueCallees(blkCall);
         }
 
         if ((pred_begin(cur) == pred_end(cur))) {
             // pop-up from call
             for (auto *C : CG.getCallsOf(cast<Function>(cur->getParent()))) {
-                if (visited.insert(const_cast<llvm::BasicBlock *>(
-                                           C->getParent()))
-                            .second)
-                    queue.push(const_cast<llvm::BasicBlock *>(C->getParent()));
+                enqueue(const_cast<llvm::BasicBlock *>(C->getParent()));
             }
         } else {
             for (auto *pred : predecessors(cur)) {
-                if (visited.insert(pred).second)
-                    queue.push(pred);
+                enqueue(pred);
             }
         }
     }
@@ -147,14 +180,14 @@ bool cutoffDivergingBranches(Module &M, const std::string &entry,
     for (auto &F : M) {
         std::vector<llvm::BasicBlock *> irrelevant;
         for (auto &B : F) {
-            if (relevant.count(&B) == 0) {
+            if (!relevant[numbering.getID(&B)]) {
                 irrelevant.push_back(&B);
             }
         }
         for (auto *B : irrelevant) {
             // if this irrelevant block has predecessors in relevant,
             // replace it with abort/exit
-            if (hasRelevantPredecessor(B, relevant)) {
+            if (hasRelevantPredecessor(B, numbering, relevant)) {
                 auto *newB = BasicBlock::Create(Ctx, "diverge", &F);
                 CallInst::Create(exitF, {ConstantInt::get(argTy, 0)}, "", newB);
                 // CloneMetadata(point, new_CI);
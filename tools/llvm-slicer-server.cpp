@@ -0,0 +1,538 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "dg/tools/llvm-slicer-opts.h"
+#include "dg/tools/llvm-slicer-preprocess.h"
+#include "dg/tools/llvm-slicer-utils.h"
+#include "dg/tools/llvm-slicer.h"
+#include "git-version.h"
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Signals.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "dg/util/TimeMeasure.h"
+
+using namespace dg;
+using llvm::errs;
+
+///
+// Long-running slicer. It reads requests (one JSON object per line)
+// from the standard input or from a UNIX socket and answers each of them
+// with one line of JSON. A request looks like:
+//
+//  {"module": "file.bc", "sc": "...", "c": "...", "2c": "...",
+//   "output": "file.sliced.bc"}
+//
+// where "sc", "c" and "2c" are the same as the slicer's options of the same
+// name. All other options are given on the command line of the server.
+//
+// The parsed and preprocessed modules are cached (keyed by the hash of the
+// file's content) together with the results of pointer analysis (keyed
+// by the hash of the analysed module). The server also keeps the last
+// analysed module with the dependence graph and computed dependencies.
+// If the next request can use it (it is for the same module and, when
+// cutting off diverging branches, for the same slicing criteria),
+// the request only marks the slice and writes the sliced module.
+// Slicing changes the module and the graph, so it is done in a child
+// process that works on its copy of the memory.
+
+llvm::cl::opt<std::string> socketPath(
+        "socket",
+        llvm::cl::desc("Listen on this UNIX socket instead of reading "
+                       "the requests\n"
+                       "from the standard input."),
+        llvm::cl::value_desc("path"), llvm::cl::init(""),
+        llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> should_verify_module(
+        "dont-verify", llvm::cl::desc("Verify sliced module (default=true)."),
+        llvm::cl::init(true), llvm::cl::cat(SlicingOpts));
+
+static bool writeAll(int fd, const std::string &data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        auto n = ::write(fd, data.data() + written, data.size() - written);
+        if (n <= 0)
+            return false;
+        written += n;
+    }
+    return true;
+}
+
+class SlicingServer {
+    // a file with stored results of pointer analysis
+    struct PTAResults {
+        llvm::SmallString<128> path;
+        bool stored{false};
+
+        ~PTAResults() {
+            llvm::sys::fs::remove(path);
+            llvm::sys::DontRemoveFileOnSignal(path);
+        }
+    };
+
+    struct CachedModule {
+        // the module after removing the unused parts
+        llvm::SmallVector<char, 0> bitcode;
+        // the results of pointer analysis keyed by the hash of the analysed
+        // module, cutting off diverging branches changes the module
+        // depending on the slicing criteria
+        std::map<std::string, std::unique_ptr<PTAResults>> ptaResults;
+    };
+
+    // a module with built dependence graph and computed dependencies
+    struct AnalysedModule {
+        std::string key;
+        SlicerOptions options;
+        // every analysed module has its own context, parsing the module
+        // again into a shared context would rename its types
+        llvm::LLVMContext context;
+        std::unique_ptr<llvm::Module> module;
+        std::unique_ptr<::Slicer> slicer;
+        // cutting off diverging branches found no slicing criteria
+        bool noCriteria{false};
+        bool ptaLoaded{false};
+
+        AnalysedModule(std::string k, const SlicerOptions &opts)
+                : key(std::move(k)), options(opts) {}
+    };
+
+    const SlicerOptions &_options;
+    std::map<std::string, std::unique_ptr<CachedModule>> _cache;
+    std::unique_ptr<AnalysedModule> _analysed;
+
+    static llvm::json::Value error(const std::string &msg) {
+        return llvm::json::Object{{"ok", false}, {"error", msg}};
+    }
+
+    static std::string getString(const llvm::json::Object &req,
+                                 const char *key) {
+        if (auto str = req.getString(key))
+            return str->str();
+        return "";
+    }
+
+    static std::string getHash(const std::vector<llvm::StringRef> &parts) {
+        llvm::MD5 hash;
+        for (const auto &part : parts) {
+            hash.update(part);
+            // separate the parts so that ("ab", "c") != ("a", "bc")
+            hash.update(llvm::StringRef("\0", 1));
+        }
+        llvm::MD5::MD5Result result;
+        hash.final(result);
+        return result.digest().str().str();
+    }
+
+    static std::string getModuleHash(const llvm::Module &M) {
+        llvm::SmallVector<char, 0> bitcode;
+        llvm::raw_svector_ostream ostream(bitcode);
+        llvm::WriteBitcodeToFile(M, ostream);
+        return getHash({llvm::StringRef(bitcode.data(), bitcode.size())});
+    }
+
+    std::string getKey(const llvm::MemoryBuffer &buf) const {
+        // the options are fixed for the whole run of the server,
+        // but make the key robust against changing that
+        return getHash({buf.getBuffer(), _options.dgOptions.entryFunction});
+    }
+
+    // the key of the analysed module
+    static std::string getAnalysisKey(const std::string &moduleKey,
+                                      const SlicerOptions &options) {
+        // without cutting off diverging branches, the analysed module
+        // does not depend on the slicing criteria
+        if (!options.cutoffDiverging)
+            return moduleKey;
+        return getHash({moduleKey, options.slicingCriteria,
+                        options.legacySlicingCriteria,
+                        options.legacySecondarySlicingCriteria,
+                        options.criteriaAreNextInstr ? "1" : "0"});
+    }
+
+    CachedModule *getCachedModule(const std::string &key,
+                                  const llvm::MemoryBuffer &buf,
+                                  const SlicerOptions &options) {
+        auto &entry = _cache[key];
+        if (entry)
+            return entry.get();
+
+        // the parsed module is only written back into the cache
+        llvm::LLVMContext context;
+        llvm::SMDiagnostic smd;
+        auto M = llvm::parseIR(buf.getMemBufferRef(), smd, context);
+        if (!M) {
+            smd.print("llvm-slicer-server", errs());
+            _cache.erase(key);
+            return nullptr;
+        }
+
+        ModuleWriter writer(options, M.get());
+        writer.removeUnusedFromModule();
+
+        entry.reset(new CachedModule());
+        llvm::raw_svector_ostream ostream(entry->bitcode);
+        llvm::WriteBitcodeToFile(*M, ostream);
+
+        return entry.get();
+    }
+
+    static PTAResults *getPTAResults(CachedModule &entry,
+                                     const std::string &key) {
+        auto &results = entry.ptaResults[key];
+        if (results)
+            return results.get();
+
+        results.reset(new PTAResults());
+        int fd;
+        if (llvm::sys::fs::createTemporaryFile("dg-pta", "bin", fd,
+                                               results->path)) {
+            entry.ptaResults.erase(key);
+            return nullptr;
+        }
+
+        ::close(fd);
+        llvm::sys::RemoveFileOnSignal(results->path);
+        return results.get();
+    }
+
+    static std::unique_ptr<AnalysedModule>
+    analyse(const std::string &key, CachedModule &entry,
+            const SlicerOptions &options, std::string &err) {
+        std::unique_ptr<AnalysedModule> A(new AnalysedModule(key, options));
+        auto &opts = A->options;
+
+        llvm::StringRef data(entry.bitcode.data(), entry.bitcode.size());
+        auto parsed = llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef(data, opts.inputFile), A->context);
+        if (!parsed) {
+            llvm::consumeError(parsed.takeError());
+            err = "Failed parsing the cached module";
+            return nullptr;
+        }
+        A->module = std::move(*parsed);
+        llvm::Module &M = *A->module;
+
+        if (!M.getFunction(opts.dgOptions.entryFunction)) {
+            err = "The entry function not found: " +
+                  opts.dgOptions.entryFunction;
+            return nullptr;
+        }
+
+        if (opts.cutoffDiverging) {
+            auto csvalues = getSlicingCriteriaValues(
+                    M, opts.slicingCriteria, opts.legacySlicingCriteria,
+                    opts.legacySecondarySlicingCriteria,
+                    opts.criteriaAreNextInstr);
+            if (csvalues.empty()) {
+                A->noCriteria = true;
+                return A;
+            }
+
+            if (!llvmdg::cutoffDivergingBranches(
+                        M, opts.dgOptions.entryFunction, csvalues)) {
+                err = "Failed cutting off diverging branches";
+                return nullptr;
+            }
+        }
+
+        auto &PTAOptions = opts.dgOptions.PTAOptions;
+        PTAResults *results = nullptr;
+        if (!PTAOptions.isSVF())
+            results = getPTAResults(
+                    entry, opts.cutoffDiverging ? getModuleHash(M) : "");
+        if (results) {
+            if (results->stored)
+                PTAOptions.loadResultsFrom = results->path.str().str();
+            else
+                PTAOptions.saveResultsTo = results->path.str().str();
+        }
+
+        A->slicer.reset(new ::Slicer(&M, opts));
+        if (!A->slicer->buildDG()) {
+            err = "Failed building DG";
+            return nullptr;
+        }
+        A->slicer->computeDependencies();
+
+        if (results) {
+            auto *PTA = static_cast<DGLLVMPointerAnalysis *>(
+                    A->slicer->getPTA());
+            A->ptaLoaded = PTA->hasLoadedResults();
+            // if loading failed, store the new results the next time
+            results->stored =
+                    A->ptaLoaded || PTAOptions.loadResultsFrom.empty();
+        }
+
+        return A;
+    }
+
+    static llvm::json::Value markAndSlice(AnalysedModule &A,
+                                          const SlicerOptions &options) {
+        std::set<LLVMNode *> criteria_nodes;
+        if (!A.noCriteria &&
+            !getSlicingCriteriaNodes(A.slicer->getDG(), options.slicingCriteria,
+                                     options.legacySlicingCriteria,
+                                     options.legacySecondarySlicingCriteria,
+                                     criteria_nodes,
+                                     options.criteriaAreNextInstr))
+            return error("Failed finding slicing criteria");
+
+        ModuleWriter writer(options, A.module.get());
+        if (criteria_nodes.empty()) {
+            ::Slicer slicer(A.module.get(), options);
+            if (!slicer.createEmptyMain())
+                return error("Failed creating an empty main");
+            if (writer.cleanAndSaveModule(should_verify_module) != 0)
+                return error("Saving the sliced module failed");
+
+            return llvm::json::Object{{"ok", true},
+                                      {"output", options.outputFile},
+                                      {"empty", true}};
+        }
+
+        if (!A.slicer->mark(criteria_nodes))
+            return error("Finding dependent nodes failed");
+
+        if (!A.slicer->slice())
+            return error("Slicing failed");
+
+        if (writer.cleanAndSaveModule(should_verify_module) != 0)
+            return error("Saving the sliced module failed");
+
+        return llvm::json::Object{{"ok", true},
+                                  {"output", options.outputFile}};
+    }
+
+    // Run markAndSlice() in a child process, so that the analysed module
+    // stays untouched for further requests
+    static llvm::json::Value sliceAnalysed(AnalysedModule &A,
+                                           const SlicerOptions &options) {
+        int fds[2];
+        if (::pipe(fds) != 0)
+            return error("Failed creating a pipe");
+
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            return error("Failed creating the slicing process");
+        }
+
+        if (pid == 0) {
+            ::close(fds[0]);
+            std::string out;
+            llvm::raw_string_ostream os(out);
+            os << markAndSlice(A, options);
+            os.flush();
+            // do not run destructors of the parent's objects
+            ::_exit(writeAll(fds[1], out) ? 0 : 1);
+        }
+
+        ::close(fds[1]);
+        std::string out;
+        char chunk[4096];
+        ssize_t n;
+        while ((n = ::read(fds[0], chunk, sizeof(chunk))) > 0)
+            out.append(chunk, n);
+        ::close(fds[0]);
+
+        int status;
+        if (::waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+            WEXITSTATUS(status) != 0)
+            return error("The slicing process failed");
+
+        auto response = llvm::json::parse(out);
+        if (!response) {
+            llvm::consumeError(response.takeError());
+            return error("The slicing process failed");
+        }
+        return std::move(*response);
+    }
+
+    llvm::json::Value slice(const llvm::json::Object &req) {
+        SlicerOptions options = _options;
+        options.inputFile = getString(req, "module");
+        options.outputFile = getString(req, "output");
+        options.slicingCriteria = getString(req, "sc");
+        options.legacySlicingCriteria = getString(req, "c");
+        options.legacySecondarySlicingCriteria = getString(req, "2c");
+
+        if (options.inputFile.empty())
+            return error("No module given");
+        if (options.slicingCriteria.empty() &&
+            options.legacySlicingCriteria.empty())
+            return error("No slicing criteria given");
+        if (options.outputFile.empty()) {
+            options.outputFile = options.inputFile;
+            replace_suffix(options.outputFile, ".sliced");
+        }
+
+        if (options.cutoffDiverging && options.dgOptions.threads)
+            options.cutoffDiverging = false;
+
+        auto buf = llvm::MemoryBuffer::getFile(options.inputFile);
+        if (!buf)
+            return error("Failed reading module '" + options.inputFile + "'");
+
+        auto moduleKey = getKey(**buf);
+        auto *entry = getCachedModule(moduleKey, **buf, options);
+        if (!entry)
+            return error("Failed reading module '" + options.inputFile + "'");
+
+        auto key = getAnalysisKey(moduleKey, options);
+        bool graphReused = _analysed && _analysed->key == key;
+        if (!graphReused) {
+            // keep only one analysed module in memory
+            _analysed.reset();
+            std::string err;
+            _analysed = analyse(key, *entry, options, err);
+            if (!_analysed)
+                return error(err);
+        }
+
+        auto response = sliceAnalysed(*_analysed, options);
+        if (auto *obj = response.getAsObject()) {
+            bool ptaLoaded = !graphReused && _analysed->ptaLoaded;
+            (*obj)["graph_reused"] = graphReused;
+            (*obj)["pta_loaded"] = ptaLoaded;
+            (*obj)["cached"] = graphReused || ptaLoaded;
+        }
+        return response;
+    }
+
+  public:
+    SlicingServer(const SlicerOptions &opts) : _options(opts) {}
+
+    std::string handle(const std::string &line) {
+        dg::debug::TimeMeasure tm;
+        tm.start();
+
+        llvm::json::Value response = nullptr;
+        auto req = llvm::json::parse(line);
+        if (!req) {
+            response = error(llvm::toString(req.takeError()));
+        } else if (auto *obj = req->getAsObject()) {
+            response = slice(*obj);
+        } else {
+            response = error("The request is not a JSON object");
+        }
+
+        tm.stop();
+        if (auto *obj = response.getAsObject())
+            (*obj)["time_ms"] = static_cast<int64_t>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                            tm.duration())
+                            .count());
+
+        std::string ret;
+        llvm::raw_string_ostream os(ret);
+        os << response;
+        os.flush();
+        return ret;
+    }
+};
+
+static int serveStdin(SlicingServer &server) {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (line.empty())
+            continue;
+        std::cout << server.handle(line) << std::endl;
+    }
+    return 0;
+}
+
+static void serveConnection(SlicingServer &server, int fd) {
+    std::string buf;
+    char chunk[4096];
+    ssize_t n;
+    while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+        buf.append(chunk, n);
+        size_t pos;
+        while ((pos = buf.find('\n')) != std::string::npos) {
+            auto line = buf.substr(0, pos);
+            buf.erase(0, pos + 1);
+            if (line.empty())
+                continue;
+            if (!writeAll(fd, server.handle(line) + "\n"))
+                return;
+        }
+    }
+}
+
+static int serveSocket(SlicingServer &server, const std::string &path) {
+    struct sockaddr_un addr {};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        errs() << "The path of the socket is too long: " << path << "\n";
+        return 1;
+    }
+
+    int sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        errs() << "Failed creating a socket\n";
+        return 1;
+    }
+
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+    ::unlink(path.c_str());
+    if (::bind(sock, reinterpret_cast<struct sockaddr *>(&addr),
+               sizeof(addr)) != 0 ||
+        ::listen(sock, 1) != 0) {
+        errs() << "Failed listening on the socket " << path << "\n";
+        ::close(sock);
+        return 1;
+    }
+
+    errs() << "[llvm-slicer-server] listening on " << path << "\n";
+
+    // the clients are served one after another,
+    // the analyses are not thread-safe
+    int fd;
+    while ((fd = ::accept(sock, nullptr, nullptr)) >= 0) {
+        serveConnection(server, fd);
+        ::close(fd);
+    }
+
+    ::close(sock);
+    ::unlink(path.c_str());
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    setupStackTraceOnError(argc, argv);
+
+    llvm::cl::SetVersionPrinter([](llvm::raw_ostream & /*unused*/) {
+        printf("%s\n", GIT_VERSION);
+    });
+
+    SlicerOptions options = parseSlicerOptions(argc, argv,
+                                               /* requireCrit = */ false,
+                                               /* inputFileRequired = */ false);
+
+    SlicingServer server(options);
+    if (socketPath.empty())
+        return serveStdin(server);
+    return serveSocket(server, socketPath);
+}
@@ -77,6 +77,19 @@ llvm::cl::opt<std::string> annotationOpts(
         llvm::cl::value_desc("val1,val2,..."), llvm::cl::init(""),
         llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> annotate_only_slice(
+        "annotate-only-slice",
+        llvm::cl::desc("Annotate only functions that contain a part of"
+                       " the slice (default=false)."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<unsigned> annotate_workers(
+        "annotate-workers",
+        llvm::cl::desc("The number of threads that compute the annotations\n"
+                       "(default=1, 0 means the number of CPUs)."),
+        llvm::cl::value_desc("N"), llvm::cl::init(1),
+        llvm::cl::cat(SlicingOpts));
+
 static void maybe_print_statistics(llvm::Module *M,
                                    const char *prefix = nullptr) {
     if (!statistics)
@@ -226,7 +239,8 @@ int main(int argc, char *argv[]) {
     }
 
     ModuleAnnotator annotator(options, &slicer.getDG(),
-                              parseAnnotationOptions(annotationOpts));
+                              parseAnnotationOptions(annotationOpts),
+                              annotate_only_slice, annotate_workers);
 
     std::set<LLVMNode *> criteria_nodes;
     if (!getSlicingCriteriaNodes(slicer.getDG(), options.slicingCriteria,
@@ -1,10 +1,7 @@
-#include <fstream>
-#include <iostream>
-#include <limits>
 #include <map>
-#include <set>
-#include <sstream>
-#include <stack>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <llvm/Config/llvm-config.h>
 
@@ -14,114 +11,208 @@
 #include <llvm/DebugInfo/DIContext.h>
 #endif
 
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/CommandLine.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
-#include <llvm/Support/raw_os_ostream.h>
+#include <llvm/Support/raw_ostream.h>
 
 llvm::cl::opt<std::string> inputFile(llvm::cl::Positional, llvm::cl::Required,
                                      llvm::cl::desc("<input file>"),
                                      llvm::cl::init(""));
 
-llvm::cl::opt<std::string> sourceFile(llvm::cl::Positional, llvm::cl::Optional,
-                                      llvm::cl::desc("[source code]"),
-                                      llvm::cl::init(""));
+llvm::cl::list<std::string> sourceFiles(llvm::cl::Positional,
+                                        llvm::cl::ZeroOrMore,
+                                        llvm::cl::desc("[source code...]"));
 
-// lines with matching braces
-std::vector<std::pair<unsigned, unsigned>> matching_braces;
-// mapping line->index in matching_braces
-std::map<unsigned, unsigned> nesting_structure;
+// Lines that are present in the module, a bitset for every source file
+// mentioned in the debug info. The bitsets are indexed by the line number.
+class KeptLines {
+    std::map<std::string, std::vector<bool>> _files;
+#if ((LLVM_VERSION_MAJOR > 3) ||                                               \
+     ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR > 6)))
+    // the debug info shares the file descriptors,
+    // so we do not need to build the path for every instruction
+    llvm::DenseMap<const llvm::DIFile *, std::vector<bool> *> _cache;
+#endif
 
-static void get_lines_from_module(const llvm::Module &M,
-                                  std::set<unsigned> &lines) {
-    // iterate over all instructions
-    for (const auto &F : M) {
-        for (const auto &B : F) {
-            for (const auto &I : B) {
-                const auto &Loc = I.getDebugLoc();
-                // Make sure that the llvm istruction has corresponding dbg LOC
+    static std::string getPath(llvm::StringRef dir, llvm::StringRef file) {
+        if (dir.empty() || file.startswith("/"))
+            return file.str();
+        return (dir + "/" + file).str();
+    }
+
+    static void set(std::vector<bool> &lines, unsigned line) {
+        if (lines.size() <= line)
+            lines.resize(line + 1);
+        lines[line] = true;
+    }
+
+  public:
+    void add(const llvm::Instruction &I) {
+        const auto &Loc = I.getDebugLoc();
+        // Make sure that the llvm istruction has corresponding dbg LOC
 #if ((LLVM_VERSION_MAJOR > 3) ||                                               \
      ((LLVM_VERSION_MAJOR == 3) && (LLVM_VERSION_MINOR > 6)))
-                if (Loc)
+        if (!Loc || Loc.getLine() == 0)
+            return;
+
+        const auto *file = Loc->getFile();
+        auto *&lines = _cache[file];
+        if (!lines)
+            lines = &_files[getPath(Loc->getDirectory(), Loc->getFilename())];
+        set(*lines, Loc.getLine());
 #else
-                if (Loc.getLine() > 0)
+        if (Loc.getLine() > 0)
+            set(_files[""], Loc.getLine());
 #endif
-                    lines.insert(Loc.getLine());
+    }
+
+    const std::map<std::string, std::vector<bool>> &files() const {
+        return _files;
+    }
+
+    // get the lines of the files that match the given source file.
+    // If there is no such file, we assume that the source file
+    // was moved and take all the lines (as we did when the tool
+    // did not know about files at all)
+    std::vector<bool> get(const std::string &source) const {
+        std::vector<bool> ret;
+        bool found = false;
+        for (int pass = 0; pass < 2 && !found; ++pass) {
+            for (const auto &it : _files) {
+                if (pass == 0 && !pathMatch(it.first, source))
+                    continue;
+                found = true;
+                if (ret.size() < it.second.size())
+                    ret.resize(it.second.size());
+                for (size_t i = 0; i < it.second.size(); ++i) {
+                    if (it.second[i])
+                        ret[i] = true;
+                }
             }
         }
+        return ret;
     }
 
-    // iterate over all globals
-    /*
-    for (const GlobalVariable& G : M->globals()) {
-        const DebugLoc& Loc = G.getDebugLoc();
-        lines.insert(Loc.getLine());
+    // do the paths refer to the same file? One of the paths
+    // must be a suffix (on the path components) of the other one
+    static bool pathMatch(llvm::StringRef a, llvm::StringRef b) {
+        if (a.size() < b.size())
+            std::swap(a, b);
+        if (!a.endswith(b))
+            return false;
+        return a.size() == b.size() || b.startswith("/") ||
+               a[a.size() - b.size() - 1] == '/';
     }
-    */
-}
+};
 
-static void get_nesting_structure(const std::string &source) {
-    std::ifstream ifs(source);
-    if (!ifs.is_open() || ifs.bad()) {
-        llvm::errs() << "Failed opening given source file: " << source << "\n";
-        abort();
+static void get_lines_from_module(const llvm::Module &M, KeptLines &lines) {
+    // iterate over all instructions
+    for (const auto &F : M) {
+        for (const auto &B : F) {
+            for (const auto &I : B) {
+                lines.add(I);
+            }
+        }
     }
+}
+
+// Extend the lines such that the lines with the braces of all the blocks
+// that contain a kept line are kept too (we do not want to get
+// a code without the function header and without the closing brace).
+// The braces are matched within one pass over the file.
+static void add_matching_braces(llvm::StringRef source,
+                                std::vector<bool> &lines) {
+    static const unsigned NONE = ~static_cast<unsigned>(0);
+
+    // lines with matching braces
+    std::vector<std::pair<unsigned, unsigned>> matching_braces;
+    // the innermost block at the beginning of each line
+    // (index into matching_braces)
+    std::vector<unsigned> enclosing{NONE, NONE};
+    std::vector<unsigned> nesting;
 
-    char ch;
     unsigned cur_line = 1;
-    unsigned idx;
-    std::stack<unsigned> nesting;
-    while (ifs.get(ch)) {
+    for (char ch : source) {
         switch (ch) {
         case '\n':
             ++cur_line;
-            if (!nesting.empty())
-                nesting_structure.emplace(cur_line, nesting.top());
+            enclosing.push_back(nesting.empty() ? NONE : nesting.back());
             break;
         case '{':
-            nesting.push(matching_braces.size());
+            nesting.push_back(matching_braces.size());
             matching_braces.emplace_back(cur_line, 0);
             break;
         case '}':
-            idx = nesting.top();
-            assert(idx < matching_braces.size());
-            assert(matching_braces[idx].second == 0);
-            matching_braces[idx].second = cur_line;
-            nesting.pop();
+            // ignore unbalanced braces
+            if (nesting.empty())
+                break;
+            matching_braces[nesting.back()].second = cur_line;
+            nesting.pop_back();
             break;
         default:
             break;
         }
     }
 
-    ifs.close();
-}
+    if (lines.size() < enclosing.size())
+        lines.resize(enclosing.size());
 
-static void print_lines(std::ifstream &ifs, std::set<unsigned> &lines) {
-    char buf[1024];
-    unsigned cur_line = 1;
-    while (!ifs.eof()) {
-        ifs.getline(buf, sizeof buf);
+    std::vector<unsigned> worklist;
+    for (unsigned i = 0; i < lines.size(); ++i) {
+        if (lines[i])
+            worklist.push_back(i);
+    }
 
-        if (lines.count(cur_line) > 0) {
-            std::cout << cur_line << ": ";
-            std::cout << buf << "\n";
-        }
+    auto keep = [&](unsigned line) {
+        if (line == 0 || lines[line])
+            return;
+        lines[line] = true;
+        worklist.push_back(line);
+    };
 
-        if (ifs.bad()) {
-            llvm::errs() << "An error occured\n";
-            break;
-        }
+    while (!worklist.empty()) {
+        unsigned line = worklist.back();
+        worklist.pop_back();
 
+        if (line >= enclosing.size() || enclosing[line] == NONE)
+            continue;
+        const auto &pr = matching_braces[enclosing[line]];
+        keep(pr.first);
+        keep(pr.second);
+    }
+}
+
+static void print_lines(llvm::raw_ostream &out, llvm::StringRef source,
+                        const std::vector<bool> &lines) {
+    unsigned cur_line = 1;
+    while (!source.empty() && cur_line < lines.size()) {
+        auto line = source.split('\n');
+        if (lines[cur_line])
+            out << cur_line << ": " << line.first << "\n";
+        source = line.second;
         ++cur_line;
     }
 }
 
-static void print_lines_numbers(std::set<unsigned> &lines) {
-    for (unsigned ln : lines)
-        std::cout << ln << "\n";
+static void print_lines_numbers(llvm::raw_ostream &out,
+                                const KeptLines &lines) {
+    const auto &files = lines.files();
+    for (const auto &it : files) {
+        for (unsigned ln = 0; ln < it.second.size(); ++ln) {
+            if (!it.second[ln])
+                continue;
+            // print just the numbers if there is no ambiguity
+            if (files.size() > 1)
+                out << it.first << ":";
+            out << ln << "\n";
+        }
+    }
 }
 
 int main(int argc, char *argv[]) {
@@ -141,43 +232,30 @@ int main(int argc, char *argv[]) {
     // FIXME find out if we have debugging info at all
     // no difficult machineris - just find out
     // which lines are in our module and print them
-    std::set<unsigned> lines;
+    KeptLines lines;
     get_lines_from_module(*M, lines);
 
-    if (sourceFile.empty())
-        print_lines_numbers(lines);
-    else {
-        get_nesting_structure(sourceFile);
-        /* fill in the lines with braces */
-        /* really not efficient, but easy */
-        size_t old_size;
-        do {
-            old_size = lines.size();
-            std::set<unsigned> new_lines;
-
-            for (unsigned i : lines) {
-                new_lines.insert(i);
-                auto it = nesting_structure.find(i);
-                if (it != nesting_structure.end()) {
-                    auto &pr = matching_braces[it->second];
-                    new_lines.insert(pr.first);
-                    new_lines.insert(pr.second);
-                }
-            }
-
-            lines.swap(new_lines);
-        } while (lines.size() > old_size);
+    auto &out = llvm::outs();
+    if (sourceFiles.empty()) {
+        print_lines_numbers(out, lines);
+        return 0;
+    }
 
-        std::ifstream ifs(sourceFile);
-        if (!ifs.is_open() || ifs.bad()) {
+    for (const auto &sourceFile : sourceFiles) {
+        // the buffer is memory-mapped if the file is big enough
+        auto buf = llvm::MemoryBuffer::getFile(sourceFile);
+        if (!buf) {
             llvm::errs() << "Failed opening given source file: " << sourceFile
                          << "\n";
             return 1;
         }
 
-        // print_lines_numbers(lines);
-        print_lines(ifs, lines);
-        ifs.close();
+        auto fileLines = lines.get(sourceFile);
+        add_matching_braces((*buf)->getBuffer(), fileLines);
+
+        if (sourceFiles.size() > 1)
+            out << "==> " << sourceFile << " <==\n";
+        print_lines(out, (*buf)->getBuffer(), fileLines);
     }
 
     return 0;
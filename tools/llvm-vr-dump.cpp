@@ -42,6 +42,24 @@ llvm::cl::opt<unsigned> max_iter("max-iter",
                                  llvm::cl::desc("Maximal number of iterations"),
                                  llvm::cl::init(20));
 
+llvm::cl::opt<unsigned> max_loop_iter(
+        "max-loop-iter",
+        llvm::cl::desc("Maximal number of changes of relations at a loop\n"
+                       "header before they are widened (0 = unlimited)"),
+        llvm::cl::init(0));
+
+llvm::cl::opt<unsigned>
+        timeout("timeout",
+                llvm::cl::desc("Time budget of the analysis in milliseconds\n"
+                               "(0 = unlimited)"),
+                llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> max_buckets(
+        "max-buckets",
+        llvm::cl::desc("Maximal number of buckets at a location\n"
+                       "(0 = unlimited)"),
+        llvm::cl::init(0));
+
 llvm::cl::opt<std::string> inputFile(llvm::cl::Positional, llvm::cl::Required,
                                      llvm::cl::desc("<input file>"),
                                      llvm::cl::init(""));
@@ -160,8 +178,14 @@ int main(int argc, char *argv[]) {
     StructureAnalyzer structure(*M, codeGraph);
     structure.analyzeBeforeRelationsAnalysis();
 
-    RelationsAnalyzer ra(*M, codeGraph, structure);
-    unsigned num_iter = ra.analyze(max_iter);
+    RelationsAnalyzerOptions opts;
+    opts.maxPass = max_iter;
+    opts.maxLoopIterations = max_loop_iter;
+    opts.timeout = timeout;
+    opts.maxBuckets = max_buckets;
+
+    RelationsAnalyzer ra(*M, codeGraph, structure, opts);
+    unsigned num_iter = ra.analyze();
     structure.analyzeAfterRelationsAnalysis();
     // call to analyzeAfterRelationsAnalysis is unnecessary, but better for
     // testing end analysis
@@ -170,6 +194,16 @@ int main(int argc, char *argv[]) {
     tm.report("INFO: Value Relations analysis took");
     std::cerr << "INFO: The analysis made " << num_iter << " passes."
               << "\n";
+
+    const auto &stats = ra.getStatistics();
+    std::cerr << "INFO: Widened loop headers: " << stats.widenedLocations
+              << "\n";
+    std::cerr << "INFO: Locations over budget: " << stats.overBudgetLocations
+              << "\n";
+    std::cerr << "INFO: Functions without fixpoint: "
+              << stats.unfinishedFunctions << "\n";
+    if (stats.timedOut)
+        std::cerr << "INFO: The analysis ran out of time\n";
     std::cerr << "\n";
 
     if (todot)